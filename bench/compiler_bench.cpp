@@ -0,0 +1,257 @@
+// Note:
+// Measure throughput of the parser, the analyzer and the code generator on
+// synthetic programs of growing size.  When the time per line grows with the
+// size of the program, the phase has a super-linear cost somewhere.
+//
+//   $ make dachs-bench
+//   $ bench/dachs-compiler-bench [--json] [--scales=1,2,4,8] [--repeat=3]
+//                                [--funcs=N] [--depth=N] [--templates=N] [--expr-length=N]
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+
+#include "dachs/ast/ast.hpp"
+#include "dachs/parser/parser.hpp"
+#include "dachs/parser/importer.hpp"
+#include "dachs/semantics/semantic_analysis.hpp"
+#include "dachs/codegen/llvmir/ir_emitter.hpp"
+#include "dachs/codegen/llvmir/context.hpp"
+
+#include "synthetic_program.hpp"
+
+namespace dachs {
+namespace bench {
+
+struct phase_result {
+    double sec;
+    double lines_per_sec;
+};
+
+struct scale_result {
+    std::size_t scale;
+    std::size_t lines;
+    std::size_t instantiations;
+    phase_result parse;
+    phase_result analysis;
+    phase_result codegen;
+};
+
+template<class F>
+double measure_sec(F const& f)
+{
+    auto const start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median_of(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    auto const n = v.size();
+    return n % 2u == 1u ? v[n / 2u] : (v[n / 2u - 1u] + v[n / 2u]) / 2.0;
+}
+
+// Note:
+// Instantiated functions and classes are not in AST.  They are held by their template.
+std::size_t count_instantiations(ast::ast const& a)
+{
+    std::size_t n = 0u;
+    for (auto const& f : a.root->functions) {
+        n += f->instantiated.size();
+    }
+    for (auto const& c : a.root->classes) {
+        n += c->instantiated.size();
+        for (auto const& i : c->instantiated) {
+            for (auto const& m : i->member_funcs) {
+                n += m->instantiated.size();
+            }
+        }
+    }
+    return n;
+}
+
+scale_result run_scale(synthetic_program_shape const& base, std::size_t const scale, std::size_t const repeat)
+{
+    auto const program = generate_synthetic_program(base.scaled(scale));
+    std::string const file = "synthetic.dcs";
+    std::vector<std::string> const import_dirs;
+    syntax::parser parser;
+
+    std::vector<double> parse_secs, analysis_secs, codegen_secs;
+    std::size_t instantiations = 0u;
+
+    for (std::size_t r = 0u; r < repeat; ++r) {
+        boost::optional<ast::ast> parsed;
+        parse_secs.push_back(measure_sec([&]{ parsed = parser.parse(program.code, file); }));
+
+        syntax::importer importer{import_dirs, file};
+        boost::optional<semantics::semantics_context> sctx;
+        analysis_secs.push_back(measure_sec([&]{ sctx = semantics::analyze_semantics(*parsed, importer); }));
+        instantiations = count_instantiations(*parsed);
+
+        codegen::llvmir::context context;
+        codegen_secs.push_back(measure_sec([&]{ codegen::llvmir::emit_llvm_ir(*parsed, *sctx, context); }));
+    }
+
+    auto const result_of
+        = [&](std::vector<double> const& secs)
+        {
+            auto const sec = median_of(secs);
+            return phase_result{sec, sec > 0.0 ? program.lines / sec : 0.0};
+        };
+
+    return {
+        scale,
+        program.lines,
+        instantiations,
+        result_of(parse_secs),
+        result_of(analysis_secs),
+        result_of(codegen_secs)
+    };
+}
+
+// Note:
+// Growth of the time per line compared with the previous scale.  1.0 means linear.
+double per_line_growth(phase_result const& prev, std::size_t const prev_lines, phase_result const& cur, std::size_t const cur_lines)
+{
+    if (prev.sec <= 0.0 || cur_lines == 0u) {
+        return 0.0;
+    }
+    return (cur.sec / cur_lines) / (prev.sec / prev_lines);
+}
+
+void print_table(std::vector<scale_result> const& results)
+{
+    std::cout << boost::format("%6s %8s %8s %14s %14s %14s %16s\n")
+                % "scale" % "lines" % "insts" % "parse lines/s" % "analyze lines/s" % "codegen lines/s" % "insts/s (analyze)";
+
+    for (auto const& r : results) {
+        std::cout << boost::format("%6d %8d %8d %14.0f %14.0f %14.0f %16.0f\n")
+                    % r.scale
+                    % r.lines
+                    % r.instantiations
+                    % r.parse.lines_per_sec
+                    % r.analysis.lines_per_sec
+                    % r.codegen.lines_per_sec
+                    % (r.analysis.sec > 0.0 ? r.instantiations / r.analysis.sec : 0.0);
+    }
+
+    if (results.size() < 2u) {
+        return;
+    }
+
+    std::cout << "\nGrowth of time per line from the previous scale (1.0 is linear)\n"
+              << boost::format("%6s %10s %10s %10s\n") % "scale" % "parse" % "analyze" % "codegen";
+    for (std::size_t i = 1u; i < results.size(); ++i) {
+        auto const& p = results[i - 1u];
+        auto const& c = results[i];
+        std::cout << boost::format("%6d %10.2f %10.2f %10.2f\n")
+                    % c.scale
+                    % per_line_growth(p.parse, p.lines, c.parse, c.lines)
+                    % per_line_growth(p.analysis, p.lines, c.analysis, c.lines)
+                    % per_line_growth(p.codegen, p.lines, c.codegen, c.lines);
+    }
+}
+
+void print_json(std::vector<scale_result> const& results)
+{
+    auto const phase_json
+        = [](phase_result const& p)
+        {
+            return (boost::format("{\"sec\":%1$.6f,\"lines_per_sec\":%2$.1f}") % p.sec % p.lines_per_sec).str();
+        };
+
+    std::cout << "{\"results\":[";
+    for (auto const& r : results) {
+        if (&r != &results.front()) {
+            std::cout << ',';
+        }
+        std::cout << boost::format("\n  {\"scale\":%1%,\"lines\":%2%,\"instantiations\":%3%,\"instantiations_per_sec\":%4$.1f,\"parse\":%5%,\"analysis\":%6%,\"codegen\":%7%}")
+                    % r.scale
+                    % r.lines
+                    % r.instantiations
+                    % (r.analysis.sec > 0.0 ? r.instantiations / r.analysis.sec : 0.0)
+                    % phase_json(r.parse)
+                    % phase_json(r.analysis)
+                    % phase_json(r.codegen);
+    }
+    std::cout << "\n]}" << std::endl;
+}
+
+bool parse_number_option(std::string const& arg, char const* const prefix, std::size_t &result)
+{
+    if (!boost::algorithm::starts_with(arg, prefix)) {
+        return false;
+    }
+    result = std::strtoul(arg.c_str() + std::strlen(prefix), nullptr, 10);
+    return true;
+}
+
+} // namespace bench
+} // namespace dachs
+
+int main(int const argc, char const* const argv[])
+{
+    using namespace dachs::bench;
+
+    synthetic_program_shape shape;
+    std::vector<std::size_t> scales = {1u, 2u, 4u, 8u};
+    std::size_t repeat = 3u;
+    bool json = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (boost::algorithm::starts_with(arg, "--scales=")) {
+            auto const value_str = arg.substr(std::strlen("--scales="));
+            std::vector<std::string> values;
+            boost::algorithm::split(values, value_str, boost::is_any_of(","));
+            scales.clear();
+            for (auto const& v : values) {
+                scales.push_back(std::strtoul(v.c_str(), nullptr, 10));
+            }
+        } else if (parse_number_option(arg, "--repeat=", repeat)
+                || parse_number_option(arg, "--funcs=", shape.num_funcs)
+                || parse_number_option(arg, "--depth=", shape.call_depth)
+                || parse_number_option(arg, "--templates=", shape.num_templates)
+                || parse_number_option(arg, "--expr-length=", shape.expr_chain_length)) {
+            // Parsed
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (repeat == 0u) {
+        repeat = 1u;
+    }
+
+    std::vector<scale_result> results;
+    for (auto const s : scales) {
+        if (!json) {
+            std::cerr << "Measuring scale " << s << "..." << std::endl;
+        }
+        results.push_back(run_scale(shape, s, repeat));
+    }
+
+    if (json) {
+        print_json(results);
+    } else {
+        print_table(results);
+    }
+
+    return 0;
+}
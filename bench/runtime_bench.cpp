@@ -0,0 +1,244 @@
+// Note:
+// Compile Dachs programs at each optimization level and measure the execution
+// time of the generated executables.  Each executable is run several times and
+// the median and the variance of the wall time are reported.  Standard output of
+// the programs is discarded.
+//
+//   $ make dachs-bench-runtime
+//   $ bench/dachs-runtime-bench --compiler=path/to/dachs [--runtimedir=DIR] [--libdir=DIR]
+//                               [--repeat=5] [--levels=debug,default,release] [--json] {file.dcs}...
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+
+#include <sys/wait.h>
+
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+
+namespace dachs {
+namespace bench {
+
+namespace fs = boost::filesystem;
+
+struct options {
+    std::string compiler;
+    std::vector<std::string> compiler_flags;
+    std::vector<std::string> levels = {"debug", "default", "release"};
+    std::vector<std::string> files;
+    std::size_t repeat = 5u;
+    bool json = false;
+};
+
+struct run_result {
+    std::string program;
+    std::string level;
+    bool succeeded;
+    std::vector<double> secs;
+    double median;
+    double mean;
+    double variance;
+};
+
+char const* flag_of_level(std::string const& level)
+{
+    if (level == "debug") {
+        return "--debug";
+    } else if (level == "release") {
+        return "--release";
+    } else {
+        return "";
+    }
+}
+
+bool run_command(std::string const& command)
+{
+    auto const status = std::system(command.c_str());
+    return status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Note:
+// Returns the path to the executable.  The compiler generates the executable
+// in the current directory, so it is run in 'workdir'.
+boost::optional<fs::path> compile(options const& opts, fs::path const& source, std::string const& level, fs::path const& workdir)
+{
+    std::string command = "cd '" + workdir.string() + "' && '" + opts.compiler + "' " + flag_of_level(level);
+    for (auto const& f : opts.compiler_flags) {
+        command += " '" + f + "'";
+    }
+    command += " '" + fs::absolute(source).string() + "'";
+
+    if (!run_command(command)) {
+        return boost::none;
+    }
+
+    auto const executable = workdir / source.stem();
+    if (!fs::exists(executable)) {
+        return boost::none;
+    }
+    return executable;
+}
+
+double median_of(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    auto const n = v.size();
+    return n % 2u == 1u ? v[n / 2u] : (v[n / 2u - 1u] + v[n / 2u]) / 2.0;
+}
+
+run_result measure(options const& opts, fs::path const& source, std::string const& level, fs::path const& workdir)
+{
+    run_result result{source.stem().string(), level, false, {}, 0.0, 0.0, 0.0};
+
+    auto const executable = compile(opts, source, level, workdir);
+    if (!executable) {
+        return result;
+    }
+
+    auto const command = "'" + executable->string() + "' < /dev/null > /dev/null";
+
+    // Note: The first run warms up the page cache and is not recorded
+    run_command(command);
+
+    for (std::size_t i = 0u; i < opts.repeat; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        if (!run_command(command)) {
+            fs::remove(*executable);
+            return result;
+        }
+        result.secs.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    fs::remove(*executable);
+
+    auto const n = static_cast<double>(result.secs.size());
+    result.succeeded = true;
+    result.median = median_of(result.secs);
+    result.mean = std::accumulate(result.secs.begin(), result.secs.end(), 0.0) / n;
+    result.variance
+        = std::accumulate(
+                result.secs.begin(),
+                result.secs.end(),
+                0.0,
+                [&](double const acc, double const s){ return acc + (s - result.mean) * (s - result.mean); }
+            ) / n;
+
+    return result;
+}
+
+void print_table(std::vector<run_result> const& results)
+{
+    std::cout << boost::format("%-24s %-8s %12s %12s %14s %8s\n")
+                % "program" % "level" % "median (s)" % "mean (s)" % "variance" % "cv (%)";
+
+    for (auto const& r : results) {
+        if (!r.succeeded) {
+            std::cout << boost::format("%-24s %-8s %12s\n") % r.program % r.level % "failed";
+            continue;
+        }
+        std::cout << boost::format("%-24s %-8s %12.4f %12.4f %14.3e %8.2f\n")
+                    % r.program
+                    % r.level
+                    % r.median
+                    % r.mean
+                    % r.variance
+                    % (r.mean > 0.0 ? std::sqrt(r.variance) / r.mean * 100.0 : 0.0);
+    }
+}
+
+void print_json(std::vector<run_result> const& results)
+{
+    std::cout << "{\"results\":[";
+    for (auto const& r : results) {
+        if (&r != &results.front()) {
+            std::cout << ',';
+        }
+        std::cout << boost::format("\n  {\"program\":\"%1%\",\"level\":\"%2%\",\"succeeded\":%3%,\"median_sec\":%4$.6f,\"mean_sec\":%5$.6f,\"variance\":%6$.9f,\"runs\":[")
+                    % r.program
+                    % r.level
+                    % (r.succeeded ? "true" : "false")
+                    % r.median
+                    % r.mean
+                    % r.variance;
+        for (auto const& s : r.secs) {
+            if (&s != &r.secs.front()) {
+                std::cout << ',';
+            }
+            std::cout << boost::format("%.6f") % s;
+        }
+        std::cout << "]}";
+    }
+    std::cout << "\n]}" << std::endl;
+}
+
+} // namespace bench
+} // namespace dachs
+
+int main(int const argc, char const* const argv[])
+{
+    using namespace dachs::bench;
+
+    options opts;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        if (boost::algorithm::starts_with(arg, "--compiler=")) {
+            opts.compiler = arg.substr(std::strlen("--compiler="));
+        } else if (boost::algorithm::starts_with(arg, "--runtimedir=") || boost::algorithm::starts_with(arg, "--libdir=")) {
+            opts.compiler_flags.push_back(arg);
+        } else if (boost::algorithm::starts_with(arg, "--repeat=")) {
+            opts.repeat = std::max<std::size_t>(std::strtoul(arg.c_str() + std::strlen("--repeat="), nullptr, 10), 1u);
+        } else if (boost::algorithm::starts_with(arg, "--levels=")) {
+            auto const value_str = arg.substr(std::strlen("--levels="));
+            opts.levels.clear();
+            boost::algorithm::split(opts.levels, value_str, boost::is_any_of(","));
+        } else if (arg == "--json") {
+            opts.json = true;
+        } else if (boost::algorithm::ends_with(arg, ".dcs")) {
+            opts.files.push_back(arg);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (opts.compiler.empty() || opts.files.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --compiler={path} [--runtimedir={dir}] [--libdir={dir}] [--repeat={n}] [--levels={levels}] [--json] {file.dcs}..." << std::endl;
+        return 1;
+    }
+
+    auto const workdir = fs::temp_directory_path() / fs::unique_path("dachs-bench-%%%%-%%%%");
+    fs::create_directories(workdir);
+
+    std::vector<run_result> results;
+    for (auto const& f : opts.files) {
+        for (auto const& level : opts.levels) {
+            if (!opts.json) {
+                std::cerr << "Measuring " << f << " (" << level << ")..." << std::endl;
+            }
+            results.push_back(measure(opts, f, level, workdir));
+        }
+    }
+
+    fs::remove_all(workdir);
+
+    if (opts.json) {
+        print_json(results);
+    } else {
+        print_table(results);
+    }
+
+    auto const failed = std::count_if(results.begin(), results.end(), [](auto const& r){ return !r.succeeded; });
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,136 @@
+#if !defined DACHS_BENCH_SYNTHETIC_PROGRAM_HPP_INCLUDED
+#define      DACHS_BENCH_SYNTHETIC_PROGRAM_HPP_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+namespace dachs {
+namespace bench {
+
+// Note:
+// Shape of a generated program.  Each parameter stresses one part of the compiler.
+//   num_funcs         : Number of non-template functions.  They form call chains.
+//   call_depth        : Length of each call chain.  Deep chains make the analyzer
+//                       resolve return types recursively.
+//   num_templates     : Number of function templates and class templates.  Each is
+//                       instantiated with 'types_per_template' argument types.
+//   expr_chain_length : Number of binary operators in each function body.
+struct synthetic_program_shape {
+    std::size_t num_funcs = 100u;
+    std::size_t call_depth = 20u;
+    std::size_t num_templates = 10u;
+    std::size_t types_per_template = 4u;
+    std::size_t expr_chain_length = 20u;
+
+    synthetic_program_shape scaled(std::size_t const factor) const
+    {
+        auto s = *this;
+        s.num_funcs *= factor;
+        s.num_templates *= factor;
+        return s;
+    }
+};
+
+struct synthetic_program {
+    std::string code;
+    std::size_t lines;
+};
+
+namespace detail {
+
+inline std::string literal_of_type(std::size_t const type_idx, std::size_t const value)
+{
+    auto const v = std::to_string(value);
+    switch (type_idx % 4u) {
+    case 0u: return v;
+    case 1u: return v + 'u';
+    case 2u: return v + ".5";
+    default: return "'" + std::string(1u, static_cast<char>('a' + value % 26u)) + "'";
+    }
+}
+
+inline std::string expr_chain(std::string const& operand, std::size_t const length)
+{
+    static char const* const ops[] = {" + ", " * ", " - ", " / "};
+    std::string expr = operand;
+    for (std::size_t i = 0u; i < length; ++i) {
+        expr += ops[i % 4u];
+        // Note: Do not divide by the operand because it may be zero
+        expr += (i % 3u == 0u && i % 4u != 3u) ? operand : std::to_string(i % 7u + 1u);
+    }
+    return expr;
+}
+
+} // namespace detail
+
+// Note:
+// Generate a Dachs program which is valid for the parser, the analyzer and the
+// code generator.  The output is deterministic for the same shape.
+inline synthetic_program generate_synthetic_program(synthetic_program_shape const& shape)
+{
+    std::ostringstream out;
+    auto const depth = std::max<std::size_t>(shape.call_depth, 1u);
+
+    for (std::size_t i = 0u; i < shape.num_funcs; ++i) {
+        out << "func f" << i << "(x : int) : int\n";
+        out << "    var y := " << detail::expr_chain("x", shape.expr_chain_length) << '\n';
+        if (i % depth != 0u) {
+            out << "    y += f" << (i - 1u) << "(x - 1)\n";
+        }
+        out << "    ret y\n"
+            << "end\n\n";
+    }
+
+    // Note:
+    // Character type does not support arithmetic operators.  Templates only use
+    // comparison for it.
+    for (std::size_t i = 0u; i < shape.num_templates; ++i) {
+        out << "func g" << i << "(a, b)\n"
+            << "    ret if a < b then b else a end\n"
+            << "end\n\n";
+
+        out << "class box" << i << "\n"
+            << "    value\n\n"
+            << "    func get\n"
+            << "        ret @value\n"
+            << "    end\n\n"
+            << "    func max(other)\n"
+            << "        ret g" << i << "(@value, other)\n"
+            << "    end\n"
+            << "end\n\n";
+    }
+
+    out << "func main\n"
+        << "    var acc := 0\n";
+
+    for (std::size_t i = depth - 1u; i < shape.num_funcs; i += depth) {
+        out << "    acc += f" << i << "(" << i % 10u << ")\n";
+    }
+    if (shape.num_funcs % depth != 0u) {
+        out << "    acc += f" << (shape.num_funcs - 1u) << "(1)\n";
+    }
+
+    for (std::size_t i = 0u; i < shape.num_templates; ++i) {
+        for (std::size_t t = 0u; t < shape.types_per_template; ++t) {
+            auto const lhs = detail::literal_of_type(t, i + t);
+            auto const rhs = detail::literal_of_type(t, i + t + 1u);
+            out << "    b" << i << '_' << t << " := new box" << i << '{' << lhs << "}\n"
+                << "    b" << i << '_' << t << ".max(" << rhs << ").println\n"
+                << "    b" << i << '_' << t << ".get.println\n";
+        }
+    }
+
+    out << "    acc.println\n"
+        << "end\n";
+
+    auto code = out.str();
+    auto const lines = static_cast<std::size_t>(std::count(code.begin(), code.end(), '\n'));
+    return {std::move(code), lines};
+}
+
+} // namespace bench
+} // namespace dachs
+
+#endif    // DACHS_BENCH_SYNTHETIC_PROGRAM_HPP_INCLUDED
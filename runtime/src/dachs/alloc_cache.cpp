@@ -0,0 +1,82 @@
+#include <cstdlib>
+
+#include <gc.h>
+
+#include "dachs/alloc_cache.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+constexpr std::size_t num_size_classes = alloc_cache_max_size / alloc_cache_granule;
+
+// Note:
+// Free lists must be reachable from GC roots.  Otherwise cached objects would be
+// collected.  Thread-local storage is not scanned by GC, so the heads are stored
+// in an uncollectable object and only the pointer to it is thread-local.
+struct free_lists {
+    void *heads[num_size_classes];
+};
+
+class thread_alloc_cache {
+    free_lists *lists = nullptr;
+
+public:
+
+    ~thread_alloc_cache() noexcept
+    {
+        // Note:
+        // Cached objects become unreachable and are collected.
+        if (lists) {
+            GC_FREE(lists);
+        }
+    }
+
+    void *allocate(std::size_t const size) noexcept
+    {
+        if (!lists) {
+            lists = static_cast<free_lists *>(GC_MALLOC_UNCOLLECTABLE(sizeof(free_lists)));
+            if (!lists) {
+                return GC_MALLOC(size);
+            }
+        }
+
+        auto const index = size == 0u ? 0u : (size - 1u) / alloc_cache_granule;
+        auto *&head = lists->heads[index];
+
+        if (!head) {
+            head = GC_malloc_many((index + 1u) * alloc_cache_granule);
+            if (!head) {
+                return GC_MALLOC(size);
+            }
+        }
+
+        // Note:
+        // The first word of each object links the list.  Other words are already cleared.
+        auto *const object = head;
+        head = GC_NEXT(object);
+        GC_NEXT(object) = nullptr;
+        return object;
+    }
+};
+
+thread_local thread_alloc_cache alloc_cache;
+
+bool alloc_cache_enabled() noexcept
+{
+    static bool const enabled = !std::getenv("DACHS_NO_ALLOC_CACHE");
+    return enabled;
+}
+
+} // namespace detail
+
+void *cached_alloc(std::size_t const size) noexcept
+{
+    if (!detail::alloc_cache_enabled()) {
+        return GC_MALLOC(size);
+    }
+    return detail::alloc_cache.allocate(size);
+}
+
+} // namespace runtime
+} // namespace dachs
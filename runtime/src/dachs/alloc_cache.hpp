@@ -0,0 +1,26 @@
+#if !defined DACHS_RUNTIME_ALLOC_CACHE_HPP_INCLUDED
+#define      DACHS_RUNTIME_ALLOC_CACHE_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Thread-local free lists of small GC objects per size class.  A list is
+// refilled by GC_malloc_many(), which allocates many objects of the same size
+// taking the allocation lock only once.  Size classes are multiples of 16 bytes
+// (the granule of Boehm GC).
+constexpr std::size_t alloc_cache_granule = 16u;
+constexpr std::size_t alloc_cache_max_size = 256u;
+
+// Note:
+// Allocate a zero-cleared GC object.  'size' must not be greater than
+// alloc_cache_max_size.  When DACHS_NO_ALLOC_CACHE environment variable is set,
+// GC_malloc() is used directly (for comparison).
+void *cached_alloc(std::size_t const size) noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_ALLOC_CACHE_HPP_INCLUDED
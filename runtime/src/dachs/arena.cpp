@@ -0,0 +1,124 @@
+#include <cstring>
+
+#include "dachs/arena.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+thread_local arena *current_arena = nullptr;
+
+constexpr std::size_t align_up(std::size_t const size, std::size_t const alignment) noexcept
+{
+    return (size + alignment - 1u) & ~(alignment - 1u);
+}
+
+struct object_header {
+    std::size_t size;
+    arena *owner;
+};
+
+// Note:
+// Header is padded so that objects keep the alignment.
+constexpr std::size_t header_size = align_up(sizeof(object_header), arena::alignment);
+
+inline object_header const& header_of(void const* const p) noexcept
+{
+    return *reinterpret_cast<object_header const*>(static_cast<char const*>(p) - header_size);
+}
+
+} // namespace detail
+
+constexpr std::size_t arena::alignment;
+constexpr std::size_t arena::default_chunk_size;
+
+arena::arena(alloc_func_type const a, std::size_t const size) noexcept
+    : alloc(a), chunk_size(size == 0u ? default_chunk_size : detail::align_up(size, alignment))
+{}
+
+bool arena::next_chunk(std::size_t const required) noexcept
+{
+    // Note:
+    // Reuse chunks kept by release() at first.
+    if (current && current->next) {
+        current = current->next;
+    } else {
+        auto const header = detail::align_up(sizeof(chunk), alignment);
+        auto *const c = static_cast<chunk *>(alloc(header + chunk_size));
+        if (!c) {
+            return false;
+        }
+        c->next = nullptr;
+        c->size = chunk_size;
+
+        if (current) {
+            current->next = c;
+        } else {
+            first = c;
+        }
+        current = c;
+    }
+
+    ptr = reinterpret_cast<char *>(current) + detail::align_up(sizeof(chunk), alignment);
+    end = ptr + current->size;
+    return static_cast<std::size_t>(end - ptr) >= required;
+}
+
+void *arena::allocate(std::size_t const size) noexcept
+{
+    auto const required = detail::header_size + detail::align_up(size, alignment);
+    if (required > chunk_size) {
+        return nullptr;
+    }
+
+    if (static_cast<std::size_t>(end - ptr) < required && !next_chunk(required)) {
+        return nullptr;
+    }
+
+    auto *const header = ptr;
+    ptr += required;
+    allocated += size;
+
+    *reinterpret_cast<detail::object_header *>(header) = {size, this};
+    auto *const object = header + detail::header_size;
+
+    // Note:
+    // A reused chunk has objects allocated before release().
+    std::memset(object, 0, size);
+    return object;
+}
+
+void arena::release() noexcept
+{
+    current = first;
+    if (first) {
+        ptr = reinterpret_cast<char *>(first) + detail::align_up(sizeof(chunk), alignment);
+        end = ptr + first->size;
+    }
+    allocated = 0u;
+}
+
+std::size_t arena::size_of(void const* const p) noexcept
+{
+    return detail::header_of(p).size;
+}
+
+arena *arena::owner_of(void const* const p) noexcept
+{
+    return detail::header_of(p).owner;
+}
+
+arena *current_arena() noexcept
+{
+    return detail::current_arena;
+}
+
+arena *switch_arena(arena *const a) noexcept
+{
+    auto *const prev = detail::current_arena;
+    detail::current_arena = a;
+    return prev;
+}
+
+} // namespace runtime
+} // namespace dachs
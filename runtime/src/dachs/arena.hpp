@@ -0,0 +1,80 @@
+#if !defined DACHS_RUNTIME_ARENA_HPP_INCLUDED
+#define      DACHS_RUNTIME_ARENA_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Bump-pointer region.  Memory is carved out of chunks and released all at
+// once by release().  Each object is preceded by a header which holds its size
+// and its arena so that realloc() can copy it in O(1).  Chunks are allocated by
+// 'alloc' (GC_malloc in runtime).  So GC scans objects in an arena and collects
+// the chunks when the arena is no longer referenced.  Objects must not be used
+// after release().
+class arena {
+public:
+    using alloc_func_type = void *(*)(std::size_t);
+
+private:
+    struct chunk {
+        chunk *next;
+        std::size_t size;
+    };
+
+    alloc_func_type const alloc;
+    std::size_t const chunk_size;
+    chunk *first = nullptr;
+    chunk *current = nullptr;
+    char *ptr = nullptr;
+    char *end = nullptr;
+    std::uint64_t allocated = 0u;
+
+    bool next_chunk(std::size_t const required) noexcept;
+
+public:
+
+    static constexpr std::size_t alignment = 16u;
+    static constexpr std::size_t default_chunk_size = 64u * 1024u;
+
+    arena(alloc_func_type const alloc, std::size_t const chunk_size) noexcept;
+
+    arena(arena const&) = delete;
+    arena &operator=(arena const&) = delete;
+
+    // Note:
+    // Returned memory is zero-cleared like GC_malloc().  Return nullptr when
+    // the object is too large for a chunk.  The caller should fall back to GC.
+    void *allocate(std::size_t const size) noexcept;
+
+    // Note:
+    // O(1).  Chunks are kept and reused by later allocations.
+    void release() noexcept;
+
+    // Note:
+    // Total bytes of objects allocated since the last release.
+    std::uint64_t allocated_bytes() const noexcept
+    {
+        return allocated;
+    }
+
+    // Note:
+    // 'p' must be a pointer returned by allocate().  They read the header of 'p'.
+    static std::size_t size_of(void const* const p) noexcept;
+    static arena *owner_of(void const* const p) noexcept;
+};
+
+// Note:
+// Arena which allocations of the current thread target.  nullptr means GC heap.
+arena *current_arena() noexcept;
+
+// Note:
+// Set the current arena of this thread and return the previous one.
+arena *switch_arena(arena *const a) noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_ARENA_HPP_INCLUDED
@@ -0,0 +1,181 @@
+#include <thread>
+
+#include "dachs/channel.hpp"
+#include "dachs/task.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+// Note:
+// Spin at first because the other side usually makes progress soon.
+// Then help the scheduler so that a producer (or consumer) task queued on
+// this thread can run.
+class backoff {
+    unsigned spins = 0u;
+
+public:
+
+    void wait() noexcept
+    {
+        if (spins < 64u) {
+            ++spins;
+            return;
+        }
+
+        if (!run_pending_task()) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace detail
+
+bounded_ring::bounded_ring(std::atomic<std::uint64_t> *const seqs, std::uint64_t const capacity) noexcept
+    : sequences(seqs), mask(capacity - 1u)
+{
+    for (std::uint64_t i = 0u; i < capacity; ++i) {
+        sequences[i].store(i, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t bounded_ring::round_capacity(std::uint64_t const capacity) noexcept
+{
+    std::uint64_t c = 2u;
+    while (c < capacity) {
+        c <<= 1;
+    }
+    return c;
+}
+
+bool bounded_ring::try_claim_push(std::uint64_t &pos) noexcept
+{
+    pos = push_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        auto const seq = sequences[pos & mask].load(std::memory_order_acquire);
+        auto const diff = static_cast<std::int64_t>(seq - pos);
+        if (diff == 0) {
+            if (push_pos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+                return true;
+            }
+        } else if (diff < 0) {
+            // Note:
+            // The slot is not released by a consumer yet.  The ring is full.
+            return false;
+        } else {
+            pos = push_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void bounded_ring::publish_push(std::uint64_t const pos) noexcept
+{
+    sequences[pos & mask].store(pos + 1u, std::memory_order_release);
+}
+
+bool bounded_ring::try_claim_pop(std::uint64_t &pos) noexcept
+{
+    pos = pop_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        auto const seq = sequences[pos & mask].load(std::memory_order_acquire);
+        auto const diff = static_cast<std::int64_t>(seq - (pos + 1u));
+        if (diff == 0) {
+            if (pop_pos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed)) {
+                return true;
+            }
+        } else if (diff < 0) {
+            // Note:
+            // The slot is not published by a producer yet.  The ring is empty.
+            return false;
+        } else {
+            pos = pop_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void bounded_ring::release_pop(std::uint64_t const pos) noexcept
+{
+    sequences[pos & mask].store(pos + mask + 1u, std::memory_order_release);
+}
+
+std::uint64_t bounded_ring::claim_push() noexcept
+{
+    std::uint64_t pos;
+    detail::backoff b;
+    while (!try_claim_push(pos)) {
+        b.wait();
+    }
+    return pos;
+}
+
+std::uint64_t bounded_ring::claim_pop() noexcept
+{
+    std::uint64_t pos;
+    detail::backoff b;
+    while (!try_claim_pop(pos)) {
+        b.wait();
+    }
+    return pos;
+}
+
+std::uint64_t bounded_ring::size() const noexcept
+{
+    auto const pushed = push_pos.load(std::memory_order_relaxed);
+    auto const popped = pop_pos.load(std::memory_order_relaxed);
+    return pushed > popped ? pushed - popped : 0u;
+}
+
+spsc_queue::spsc_queue(alloc_func_type const a) noexcept
+    : alloc(a)
+{
+    head = tail = new_node(nullptr);
+}
+
+spsc_queue::node *spsc_queue::new_node(void *const value) noexcept
+{
+    auto *const n = static_cast<node *>(alloc(sizeof(node)));
+    n->next.store(nullptr, std::memory_order_relaxed);
+    n->value = value;
+    return n;
+}
+
+void spsc_queue::push(void *const value) noexcept
+{
+    auto *const n = new_node(value);
+    tail->next.store(n, std::memory_order_release);
+    tail = n;
+}
+
+bool spsc_queue::try_pop(void *&value) noexcept
+{
+    auto *const next = head->next.load(std::memory_order_acquire);
+    if (!next) {
+        return false;
+    }
+
+    // Note:
+    // 'next' becomes the new dummy node.  Clear its value so that GC can
+    // collect the popped value.
+    value = next->value;
+    next->value = nullptr;
+    head = next;
+    return true;
+}
+
+void *spsc_queue::pop() noexcept
+{
+    void *value;
+    detail::backoff b;
+    while (!try_pop(value)) {
+        b.wait();
+    }
+    return value;
+}
+
+bool spsc_queue::empty() const noexcept
+{
+    return !head->next.load(std::memory_order_acquire);
+}
+
+} // namespace runtime
+} // namespace dachs
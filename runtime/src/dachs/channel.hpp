@@ -0,0 +1,117 @@
+#if !defined DACHS_RUNTIME_CHANNEL_HPP_INCLUDED
+#define      DACHS_RUNTIME_CHANNEL_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Bounded multi-producer/multi-consumer ring buffer (D. Vyukov's algorithm).
+// It only manages a sequence number per slot.  Values are stored by the caller in
+// its own buffer at 'pos % capacity()' between claim and publish (or release).
+// This keeps typed values in Dachs memory where GC can see them.
+//
+//   push: try_claim_push(pos) -> write slot -> publish_push(pos)
+//   pop:  try_claim_pop(pos)  -> read slot  -> release_pop(pos)
+class bounded_ring {
+    std::atomic<std::uint64_t> *const sequences;
+    std::uint64_t const mask;
+
+    // Note:
+    // Producers and consumers update different cache lines.  Padding is used
+    // instead of alignas because a ring may be placed in memory allocated by GC.
+    char padding0[64];
+    std::atomic<std::uint64_t> push_pos{0u};
+    char padding1[64 - sizeof(std::atomic<std::uint64_t>)];
+    std::atomic<std::uint64_t> pop_pos{0u};
+    char padding2[64 - sizeof(std::atomic<std::uint64_t>)];
+
+public:
+
+    // Note:
+    // 'capacity' must be a power of 2.  'sequences' must have 'capacity' elements.
+    bounded_ring(std::atomic<std::uint64_t> *const sequences, std::uint64_t const capacity) noexcept;
+
+    bounded_ring(bounded_ring const&) = delete;
+    bounded_ring &operator=(bounded_ring const&) = delete;
+
+    // Note:
+    // Round up to a power of 2.  The minimum is 2.
+    static std::uint64_t round_capacity(std::uint64_t const capacity) noexcept;
+
+    // Note:
+    // Return false when the ring is full.
+    bool try_claim_push(std::uint64_t &pos) noexcept;
+    void publish_push(std::uint64_t const pos) noexcept;
+
+    // Note:
+    // Return false when the ring is empty.
+    bool try_claim_pop(std::uint64_t &pos) noexcept;
+    void release_pop(std::uint64_t const pos) noexcept;
+
+    // Note:
+    // Blocking variants.  They wait with backoff and run pending tasks meanwhile.
+    std::uint64_t claim_push() noexcept;
+    std::uint64_t claim_pop() noexcept;
+
+    std::uint64_t capacity() const noexcept
+    {
+        return mask + 1u;
+    }
+
+    // Note:
+    // Approximate while other threads push or pop.
+    std::uint64_t size() const noexcept;
+};
+
+// Note:
+// Unbounded single-producer/single-consumer queue of pointers.  It is a linked
+// list with a dummy head node.  Only the producer touches 'tail' and only the
+// consumer touches 'head', so no CAS is needed.  Nodes are never reused and
+// are allocated by 'alloc' (GC_malloc in runtime) so that GC can see the values.
+class spsc_queue {
+public:
+    using alloc_func_type = void *(*)(std::size_t);
+
+    struct node {
+        std::atomic<node *> next;
+        void *value;
+    };
+
+private:
+    alloc_func_type const alloc;
+    node *head;
+    char padding[64 - sizeof(node *)];
+    node *tail;
+
+    node *new_node(void *const value) noexcept;
+
+public:
+
+    explicit spsc_queue(alloc_func_type const alloc) noexcept;
+
+    spsc_queue(spsc_queue const&) = delete;
+    spsc_queue &operator=(spsc_queue const&) = delete;
+
+    // Note:
+    // Called only by the producer thread.
+    void push(void *const value) noexcept;
+
+    // Note:
+    // Called only by the consumer thread.  Return false when empty.
+    bool try_pop(void *&value) noexcept;
+
+    // Note:
+    // Blocking variant of try_pop().  It waits with backoff.
+    void *pop() noexcept;
+
+    bool empty() const noexcept;
+};
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_CHANNEL_HPP_INCLUDED
@@ -0,0 +1,308 @@
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <unordered_set>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "dachs/file.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+inline int open_flags_of(char const* const mode) noexcept
+{
+    bool const plus = mode[0] != '\0' && mode[1] == '+';
+
+    switch (mode[0]) {
+    case 'r':
+        return plus ? O_RDWR : O_RDONLY;
+    case 'w':
+        return (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+    case 'a':
+        return (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+    default:
+        return -1;
+    }
+}
+
+// Note:
+// Never destroyed because it is read at exit.
+struct open_files {
+    std::mutex mutex;
+    std::unordered_set<file *> files;
+};
+
+open_files &get_open_files()
+{
+    static auto *const fs = new open_files;
+    return *fs;
+}
+
+void flush_open_files_at_exit()
+{
+    flush_open_files();
+}
+
+} // namespace detail
+
+file::file(int const f, std::size_t const buffer_size)
+    : fd(f), write_buf(buffer_size)
+{
+    static bool const registered = std::atexit(detail::flush_open_files_at_exit) == 0;
+    (void) registered;
+
+    auto &fs = detail::get_open_files();
+    std::lock_guard<std::mutex> lock{fs.mutex};
+    fs.files.insert(this);
+}
+
+file::~file() noexcept
+{
+    close();
+}
+
+file *file::open(char const* const path, char const* const mode) noexcept
+{
+    auto const flags = detail::open_flags_of(mode);
+    if (flags == -1) {
+        return nullptr;
+    }
+
+    auto const fd = ::open(path, flags | O_CLOEXEC, 0666);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    // Note: No write buffer is needed for read-only files
+    auto *const f = new(std::nothrow) file{fd, flags == O_RDONLY ? 0u : default_buffer_size};
+    if (!f) {
+        ::close(fd);
+    }
+    return f;
+}
+
+bool file::write_through(char const* data, std::size_t size) noexcept
+{
+    while (size != 0u) {
+        auto const written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool file::write(char const* const data, std::size_t const size) noexcept
+{
+    if (fd == -1) {
+        return false;
+    }
+
+    if (size == 0u) {
+        return true;
+    }
+
+    if (write_size + size <= write_buf.size()) {
+        std::memcpy(write_buf.data() + write_size, data, size);
+        write_size += size;
+        return true;
+    }
+
+    if (!flush()) {
+        return false;
+    }
+
+    // Note:
+    // Large data is written directly without copying to the buffer
+    if (size >= write_buf.size()) {
+        return write_through(data, size);
+    }
+
+    std::memcpy(write_buf.data(), data, size);
+    write_size = size;
+    return true;
+}
+
+bool file::flush() noexcept
+{
+    if (fd == -1) {
+        return false;
+    }
+
+    auto const size = write_size;
+    write_size = 0u;
+    return size == 0u || write_through(write_buf.data(), size);
+}
+
+std::size_t file::read(char *const buf, std::size_t const size) noexcept
+{
+    if (fd == -1) {
+        return 0u;
+    }
+
+    std::size_t total = 0u;
+    while (total < size) {
+        auto const read_size = ::read(fd, buf + total, size - total);
+        if (read_size > 0) {
+            total += static_cast<std::size_t>(read_size);
+        } else if (read_size < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    return total;
+}
+
+char *file::read_all(std::size_t &size, realloc_func_type const realloc_func) noexcept
+{
+    size = 0u;
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    std::size_t capacity = 4096u;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        capacity = static_cast<std::size_t>(st.st_size);
+    }
+
+    auto *buf = static_cast<char *>(realloc_func(nullptr, capacity + 1u));
+    if (!buf) {
+        return nullptr;
+    }
+
+    for (;;) {
+        size += read(buf + size, capacity - size);
+        if (size < capacity) {
+            break;
+        }
+
+        // Note:
+        // The buffer is full.  Read one more byte not to grow the buffer of
+        // a regular file whose size was exact.
+        char next;
+        if (read(&next, 1u) == 0u) {
+            break;
+        }
+
+        auto *const grown = static_cast<char *>(realloc_func(buf, capacity * 2u + 1u));
+        if (!grown) {
+            return nullptr;
+        }
+        buf = grown;
+        capacity *= 2u;
+        buf[size++] = next;
+    }
+
+    buf[size] = '\0';
+    return buf;
+}
+
+std::int64_t file::size() noexcept
+{
+    struct stat st;
+    if (fd == -1 || ::fstat(fd, &st) != 0) {
+        return -1;
+    }
+    return st.st_size;
+}
+
+bool file::close() noexcept
+{
+    if (fd == -1) {
+        return false;
+    }
+
+    {
+        auto &fs = detail::get_open_files();
+        std::lock_guard<std::mutex> lock{fs.mutex};
+        fs.files.erase(this);
+    }
+
+    auto const flushed = flush();
+    auto const closed = ::close(fd) == 0;
+    fd = -1;
+    return flushed && closed;
+}
+
+bool flush_open_files() noexcept
+{
+    auto &fs = detail::get_open_files();
+    std::lock_guard<std::mutex> lock{fs.mutex};
+
+    bool succeeded = true;
+    for (auto *const f : fs.files) {
+        succeeded = f->flush() && succeeded;
+    }
+    return succeeded;
+}
+
+bool map_file(char const* const path, mapped_region &region) noexcept
+{
+    auto const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    auto const size = static_cast<std::size_t>(st.st_size);
+
+    // Note:
+    // Reserve one more byte with an anonymous mapping and map the file over it.
+    // The rest of the last page is zero-filled in both cases, so the byte after
+    // the end of the file is '\0' even if the file size is a multiple of the page size.
+    auto *const reserved = ::mmap(nullptr, size + 1u, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    if (size != 0u) {
+        auto *const mapped = ::mmap(reserved, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::munmap(reserved, size + 1u);
+            ::close(fd);
+            return false;
+        }
+
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+    }
+
+    // Note:
+    // The mapping is still valid after closing the descriptor
+    ::close(fd);
+
+    region.data = static_cast<char const*>(reserved);
+    region.size = size;
+    return true;
+}
+
+bool unmap_file(mapped_region const& region) noexcept
+{
+    if (!region.data) {
+        return false;
+    }
+
+    return ::munmap(const_cast<char *>(region.data), region.size + 1u) == 0;
+}
+
+} // namespace runtime
+} // namespace dachs
@@ -0,0 +1,83 @@
+#if !defined DACHS_RUNTIME_FILE_HPP_INCLUDED
+#define      DACHS_RUNTIME_FILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// File with a large buffer for writes.  Small writes are gathered and
+// written with one write(2) when the buffer is full or flushed.
+// Dachs has no destructor, so files which are not closed are flushed at exit.
+// Files opened read-only have no buffer.
+class file {
+    int fd;
+    std::vector<char> write_buf;
+    std::size_t write_size = 0u;
+
+    bool write_through(char const* data, std::size_t size) noexcept;
+
+public:
+
+    static std::size_t const default_buffer_size = 1024u * 1024u;
+
+    // Note:
+    // A file is registered to be flushed at exit until it is closed.
+    explicit file(int const fd, std::size_t const buffer_size = default_buffer_size);
+    ~file() noexcept;
+
+    file(file const&) = delete;
+    file &operator=(file const&) = delete;
+
+    // Note:
+    // Mode is one of "r", "w", "a", "r+", "w+" and "a+" like fopen().
+    // Return nullptr on failure.
+    static file *open(char const* const path, char const* const mode) noexcept;
+
+    bool write(char const* const data, std::size_t const size) noexcept;
+    bool flush() noexcept;
+
+    // Note:
+    // Read until 'size' bytes are read or EOF is reached.
+    // Return the number of bytes actually read.
+    std::size_t read(char *const buf, std::size_t const size) noexcept;
+
+    // Note:
+    // Read until EOF.  The buffer is allocated and grown by 'realloc_func'
+    // and terminated with '\0'.  The size of a regular file is used as the
+    // initial capacity.  Pipes, FIFOs and files in /proc report 0 as their
+    // size, so the buffer is grown while there are more bytes.  Return nullptr
+    // on failure.
+    using realloc_func_type = void *(*)(void *, std::size_t);
+    char *read_all(std::size_t &size, realloc_func_type const realloc_func) noexcept;
+
+    // Note:
+    // Return -1 on failure
+    std::int64_t size() noexcept;
+
+    bool close() noexcept;
+};
+
+// Note:
+// Read-only mapping of a whole file.  The byte after the end of the file is
+// always '\0' so the mapping can be used as a C string.
+struct mapped_region {
+    char const* data = nullptr;
+    std::size_t size = 0u;
+};
+
+// Note:
+// Flush all files not closed yet.  Called at exit automatically.
+// Return false if some of them failed.
+bool flush_open_files() noexcept;
+
+bool map_file(char const* const path, mapped_region &region) noexcept;
+bool unmap_file(mapped_region const& region) noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_FILE_HPP_INCLUDED
@@ -0,0 +1,286 @@
+#include <cstdlib>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "dachs/function_profile.hpp"
+
+namespace dachs {
+namespace runtime {
+
+function_profile::function_profile(std::size_t const n)
+    : num_slots(n)
+    , funcs(new counts[n])
+    , edges(new std::atomic<edge_counts *>[n + 1u])
+    , stack()
+{
+    for (auto i = 0u; i <= num_slots; ++i) {
+        edges[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+function_profile::~function_profile()
+{
+    for (auto i = 0u; i <= num_slots; ++i) {
+        delete[] edges[i].load(std::memory_order_relaxed);
+    }
+}
+
+void function_profile::enter(std::size_t const slot, std::uint64_t const now)
+{
+    stack.push_back({slot, now, 0u});
+}
+
+void function_profile::exit(std::uint64_t const now)
+{
+    if (stack.empty()) {
+        return;
+    }
+
+    auto const f = stack.back();
+    stack.pop_back();
+
+    auto const inclusive = now >= f.start ? now - f.start : 0u;
+    auto const exclusive = inclusive >= f.children_cycles ? inclusive - f.children_cycles : 0u;
+
+    auto caller = num_slots;
+    if (!stack.empty()) {
+        caller = stack.back().slot;
+        stack.back().children_cycles += inclusive;
+    }
+
+    if (f.slot >= num_slots) {
+        return;
+    }
+
+    auto &c = funcs[f.slot];
+    c.calls.add(1u);
+    c.inclusive_cycles.add(inclusive);
+    c.exclusive_cycles.add(exclusive);
+
+    if (!stack.empty() && caller >= num_slots) {
+        return;
+    }
+
+    auto *callees = edges[caller].load(std::memory_order_relaxed);
+    if (!callees) {
+        callees = new edge_counts[num_slots];
+        edges[caller].store(callees, std::memory_order_release);
+    }
+
+    auto &e = callees[f.slot];
+    e.calls.add(1u);
+    e.inclusive_cycles.add(inclusive);
+}
+
+std::vector<function_profile::func_entry> function_profile::func_entries(std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names)
+{
+    std::unordered_map<std::string, std::array<std::uint64_t, 3>> merged;
+    for (auto const* const p : profiles) {
+        for (auto slot = 0u; slot < p->num_slots; ++slot) {
+            auto const& f = p->funcs[slot];
+            auto const calls = f.calls.get();
+            if (calls == 0u) {
+                continue;
+            }
+
+            auto &c = merged[slot < names.size() ? names[slot] : "<unknown>"];
+            c[0] += calls;
+            c[1] += f.inclusive_cycles.get();
+            c[2] += f.exclusive_cycles.get();
+        }
+    }
+
+    std::vector<func_entry> result;
+    result.reserve(merged.size());
+    for (auto const& m : merged) {
+        result.push_back({m.first, m.second[0], m.second[1], m.second[2]});
+    }
+
+    std::sort(
+            std::begin(result),
+            std::end(result),
+            [](auto const& l, auto const& r)
+            {
+                if (l.exclusive_cycles != r.exclusive_cycles) {
+                    return l.exclusive_cycles > r.exclusive_cycles;
+                } else if (l.calls != r.calls) {
+                    return l.calls > r.calls;
+                } else {
+                    return l.name < r.name;
+                }
+            }
+        );
+
+    return result;
+}
+
+std::vector<function_profile::edge_entry> function_profile::edge_entries(std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names)
+{
+    auto const name_of
+        = [&names](std::size_t const slot) -> std::string
+        {
+            return slot < names.size() ? names[slot] : "<unknown>";
+        };
+
+    std::map<std::pair<std::string, std::string>, std::array<std::uint64_t, 2>> merged;
+    for (auto const* const p : profiles) {
+        for (auto caller = 0u; caller <= p->num_slots; ++caller) {
+            auto const* const callees = p->edges[caller].load(std::memory_order_acquire);
+            if (!callees) {
+                continue;
+            }
+
+            for (auto callee = 0u; callee < p->num_slots; ++callee) {
+                auto const calls = callees[callee].calls.get();
+                if (calls == 0u) {
+                    continue;
+                }
+
+                auto &c = merged[std::make_pair(caller == p->num_slots ? "" : name_of(caller), name_of(callee))];
+                c[0] += calls;
+                c[1] += callees[callee].inclusive_cycles.get();
+            }
+        }
+    }
+
+    std::vector<edge_entry> result;
+    result.reserve(merged.size());
+    for (auto const& m : merged) {
+        result.push_back({m.first.first, m.first.second, m.second[0], m.second[1]});
+    }
+
+    std::stable_sort(
+            std::begin(result),
+            std::end(result),
+            [](auto const& l, auto const& r)
+            {
+                return l.inclusive_cycles > r.inclusive_cycles;
+            }
+        );
+
+    return result;
+}
+
+void function_profile::report(std::FILE *const out, std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names)
+{
+    auto const fs = func_entries(profiles, names);
+    auto const es = edge_entries(profiles, names);
+
+    std::uint64_t total_cycles = 0u, total_calls = 0u;
+    for (auto const& f : fs) {
+        total_cycles += f.exclusive_cycles;
+        total_calls += f.calls;
+    }
+
+    std::fprintf(
+            out,
+            "Function profile: %" PRIu64 " calls of %zu functions in %" PRIu64 " cycles\n"
+            "%12s %16s %16s %7s  %s\n",
+            total_calls, fs.size(), total_cycles,
+            "calls", "inclusive", "exclusive", "%", "function"
+        );
+
+    for (auto const& f : fs) {
+        std::fprintf(
+                out,
+                "%12" PRIu64 " %16" PRIu64 " %16" PRIu64 " %6.2f%%  %s\n",
+                f.calls,
+                f.inclusive_cycles,
+                f.exclusive_cycles,
+                total_cycles == 0u ? 0.0 : 100.0 * f.exclusive_cycles / total_cycles,
+                f.name.c_str()
+            );
+    }
+
+    std::fprintf(out, "\nCall graph:\n%12s %16s  %s\n", "calls", "inclusive", "caller -> callee");
+
+    for (auto const& e : es) {
+        std::fprintf(
+                out,
+                "%12" PRIu64 " %16" PRIu64 "  %s -> %s\n",
+                e.calls,
+                e.inclusive_cycles,
+                e.caller.empty() ? "<root>" : e.caller.c_str(),
+                e.callee.c_str()
+            );
+    }
+}
+
+std::uint64_t read_cycle_counter() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+#endif
+}
+
+namespace detail {
+
+// Note:
+// Never destroyed because profiles may be registered in other threads at exit.
+struct function_profile_registry {
+    std::mutex mutex;
+    std::vector<char const*> names;
+    std::vector<function_profile const*> profiles;
+};
+
+function_profile_registry &registry()
+{
+    static auto *const r = new function_profile_registry;
+    return *r;
+}
+
+} // namespace detail
+
+std::size_t register_profiled_functions(char const* const* const names, std::size_t const size)
+{
+    auto &r = detail::registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    auto const first = r.names.size();
+    r.names.insert(std::end(r.names), names, names + size);
+    return first;
+}
+
+function_profile &thread_function_profile()
+{
+    thread_local function_profile *profile = nullptr;
+
+    if (!profile) {
+        auto &r = detail::registry();
+        std::lock_guard<std::mutex> lock{r.mutex};
+        profile = new function_profile{r.names.size()};
+        r.profiles.push_back(profile);
+    }
+
+    return *profile;
+}
+
+void report_function_profile_at_exit()
+{
+    std::atexit(
+            []
+            {
+                auto &r = detail::registry();
+                std::lock_guard<std::mutex> lock{r.mutex};
+                function_profile::report(stderr, r.profiles, r.names);
+            }
+        );
+}
+
+} // namespace runtime
+} // namespace dachs
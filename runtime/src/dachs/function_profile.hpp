@@ -0,0 +1,130 @@
+#if !defined DACHS_RUNTIME_FUNCTION_PROFILE_HPP_INCLUDED
+#define      DACHS_RUNTIME_FUNCTION_PROFILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Call counts and cycles per function of one thread.  It is used by executables
+// compiled with --profile-functions.  The compiler gives each instrumented
+// function a slot and each thread has its own counters for all slots, so
+// enter() and exit() neither lock nor hash.  The counters are written only by
+// the owner thread, but they are relaxed atomics because the report at exit
+// reads them while detached task workers may still be running.
+// Inclusive cycles of a recursive function count the recursive calls more than
+// once, as gprof does.
+class function_profile {
+public:
+    struct func_entry {
+        std::string name;
+        std::uint64_t calls;
+        std::uint64_t inclusive_cycles;
+        std::uint64_t exclusive_cycles;
+    };
+
+    // Note:
+    // 'caller' is empty when the callee is the bottom of the call stack of a thread.
+    struct edge_entry {
+        std::string caller;
+        std::string callee;
+        std::uint64_t calls;
+        std::uint64_t inclusive_cycles;
+    };
+
+private:
+    class counter {
+        std::atomic<std::uint64_t> value{0u};
+
+    public:
+        // Note: Only the owner thread adds, so load and store don't race.
+        void add(std::uint64_t const n) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        std::uint64_t get() const noexcept
+        {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct counts {
+        counter calls;
+        counter inclusive_cycles;
+        counter exclusive_cycles;
+    };
+
+    struct edge_counts {
+        counter calls;
+        counter inclusive_cycles;
+    };
+
+    struct frame {
+        std::size_t slot;
+        std::uint64_t start;
+        std::uint64_t children_cycles;
+    };
+
+    std::size_t const num_slots;
+    std::unique_ptr<counts[]> funcs;
+
+    // Note:
+    // Counts of the edges from a caller to each slot.  They are allocated at
+    // the first return to the caller.  The last caller is the bottom of the
+    // call stack.
+    std::unique_ptr<std::atomic<edge_counts *>[]> edges;
+
+    // Note: 'stack' is accessed only by the owner thread.
+    std::vector<frame> stack;
+
+public:
+
+    explicit function_profile(std::size_t const num_slots);
+    ~function_profile();
+
+    // Note:
+    // Calls of slots out of range are not counted.  They are functions of
+    // modules registered after the profile was created.
+    void enter(std::size_t const slot, std::uint64_t const now);
+    void exit(std::uint64_t const now);
+
+    // Note:
+    // 'names' maps a slot to its function name.  Functions which have the same
+    // name in different modules or threads are merged.  Functions are sorted by
+    // exclusive cycles and edges by inclusive cycles in descending order.
+    static std::vector<func_entry> func_entries(std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names);
+    static std::vector<edge_entry> edge_entries(std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names);
+
+    static void report(std::FILE *const out, std::vector<function_profile const*> const& profiles, std::vector<char const*> const& names);
+};
+
+std::uint64_t read_cycle_counter() noexcept;
+
+// Note:
+// Register the names of instrumented functions of a module and return the
+// slot of the first one.  Modules are registered by their constructors, so all
+// of them are registered before any thread enters a function.
+std::size_t register_profiled_functions(char const* const* const names, std::size_t const size);
+
+// Note:
+// Profile of the current thread.  It is registered to the global list on the
+// first call in the thread and is never destroyed because the report at exit
+// reads it after the thread finishes.
+function_profile &thread_function_profile();
+
+// Note:
+// Report profiles of all threads to stderr at exit.
+void report_function_profile_at_exit();
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_FUNCTION_PROFILE_HPP_INCLUDED
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <cerrno>
+#include <string>
+#include <limits>
+#include <atomic>
+#include <chrono>
+
+#include <gc.h>
+
+#include "dachs/gc.hpp"
+
+#if defined GC_VERSION_MAJOR && (GC_VERSION_MAJOR > 7 || (GC_VERSION_MAJOR == 7 && GC_VERSION_MINOR >= 4))
+# define DACHS_GC_HAS_COLLECTION_EVENT
+#endif
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+std::atomic<std::uint64_t> gc_pause_time_ns{0u};
+
+#if defined DACHS_GC_HAS_COLLECTION_EVENT
+std::chrono::steady_clock::time_point gc_start_time;
+
+// Note:
+// Called while the world is stopped and the allocation lock is held.
+// Events of a collection are not interleaved with other collections.
+void on_collection_event(GC_EventType const e)
+{
+    switch (e) {
+    case GC_EVENT_START:
+        gc_start_time = std::chrono::steady_clock::now();
+        break;
+    case GC_EVENT_END: {
+        auto const elapsed = std::chrono::steady_clock::now() - gc_start_time;
+        gc_pause_time_ns.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                std::memory_order_relaxed
+            );
+        break;
+    }
+    default:
+        break;
+    }
+}
+#endif
+
+} // namespace detail
+
+gc_config gc_config_from_env(gc_config config) noexcept
+{
+    std::uint64_t value;
+
+    if (parse_size(std::getenv("DACHS_GC_MARKERS"), value)) {
+        config.markers = value;
+    }
+
+    if (parse_size(std::getenv("DACHS_GC_INCREMENTAL"), value)) {
+        config.incremental = value != 0u;
+    }
+
+    if (parse_size(std::getenv("DACHS_GC_INITIAL_HEAP_SIZE"), value)) {
+        config.initial_heap_size = value;
+    }
+
+    if (parse_size(std::getenv("DACHS_GC_FREE_SPACE_DIVISOR"), value)) {
+        config.free_space_divisor = value;
+    }
+
+    return config;
+}
+
+void init_gc(gc_config const& config) noexcept
+{
+    if (config.markers > 0u) {
+#if defined GC_VERSION_MAJOR && GC_VERSION_MAJOR >= 8
+        GC_set_markers_count(static_cast<unsigned>(config.markers));
+#else
+        // Note:
+        // Older Boehm GC reads the number of markers only from the environment at GC_init()
+        ::setenv("GC_MARKERS", std::to_string(config.markers).c_str(), 1);
+#endif
+    }
+
+#if defined DACHS_GC_HAS_COLLECTION_EVENT
+    GC_set_on_collection_event(detail::on_collection_event);
+#endif
+
+    GC_init();
+
+    if (config.free_space_divisor > 0u) {
+        GC_set_free_space_divisor(static_cast<GC_word>(config.free_space_divisor));
+    }
+
+    if (config.initial_heap_size > 0u) {
+        auto const current = GC_get_heap_size();
+        if (current < config.initial_heap_size) {
+            GC_expand_hp(config.initial_heap_size - current);
+        }
+    }
+
+    if (config.incremental) {
+        GC_enable_incremental();
+    }
+}
+
+gc_stats get_gc_stats() noexcept
+{
+    return {
+        GC_get_heap_size(),
+        GC_get_bytes_since_gc(),
+        GC_get_gc_no(),
+        detail::gc_pause_time_ns.load(std::memory_order_relaxed)
+    };
+}
+
+} // namespace runtime
+} // namespace dachs
@@ -0,0 +1,48 @@
+#if !defined DACHS_RUNTIME_GC_HPP_INCLUDED
+#define      DACHS_RUNTIME_GC_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "dachs/size.hpp"
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// GC settings applied at program start.  0 (or false) means Boehm GC's default.
+// Values are embedded in the entry point by compiler flags (--gc-*) and
+// overridden by DACHS_GC_* environment variables at run time.
+struct gc_config {
+    std::uint64_t markers = 0u;
+    bool incremental = false;
+    std::uint64_t initial_heap_size = 0u;
+    std::uint64_t free_space_divisor = 0u;
+};
+
+// Note:
+// Statistics of GC.  'pause_time_ns' is the total time spent in collections.
+// It is measured only when the GC supports collection events (Boehm GC 7.4 or later).
+struct gc_stats {
+    std::uint64_t heap_size;
+    std::uint64_t bytes_since_gc;
+    std::uint64_t collections;
+    std::uint64_t pause_time_ns;
+};
+
+// Note:
+// Override 'config' with below environment variables if set.
+//   DACHS_GC_MARKERS, DACHS_GC_INCREMENTAL, DACHS_GC_INITIAL_HEAP_SIZE, DACHS_GC_FREE_SPACE_DIVISOR
+gc_config gc_config_from_env(gc_config config) noexcept;
+
+// Note:
+// Initialize GC with the settings.  The number of markers must be set before
+// GC_init() so it can't be changed later.
+void init_gc(gc_config const& config) noexcept;
+
+gc_stats get_gc_stats() noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_GC_HPP_INCLUDED
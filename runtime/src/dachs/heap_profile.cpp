@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <algorithm>
+#include <cinttypes>
+
+#include "dachs/heap_profile.hpp"
+
+namespace dachs {
+namespace runtime {
+
+void heap_profile::record(char const* const site, std::size_t const bytes)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto &c = sites[site];
+    c.bytes += bytes;
+    ++c.objects;
+}
+
+std::vector<heap_profile::entry> heap_profile::entries()
+{
+    std::unordered_map<std::string, counts> merged;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        for (auto const& s : sites) {
+            auto &c = merged[s.first ? s.first : "<unknown>"];
+            c.bytes += s.second.bytes;
+            c.objects += s.second.objects;
+        }
+    }
+
+    std::vector<entry> result;
+    result.reserve(merged.size());
+    for (auto const& m : merged) {
+        result.push_back({m.first, m.second.bytes, m.second.objects});
+    }
+
+    std::sort(
+            std::begin(result),
+            std::end(result),
+            [](auto const& l, auto const& r)
+            {
+                if (l.bytes != r.bytes) {
+                    return l.bytes > r.bytes;
+                } else if (l.objects != r.objects) {
+                    return l.objects > r.objects;
+                } else {
+                    return l.site < r.site;
+                }
+            }
+        );
+
+    return result;
+}
+
+void heap_profile::report(std::FILE *const out)
+{
+    auto const es = entries();
+
+    std::uint64_t total_bytes = 0u, total_objects = 0u;
+    for (auto const& e : es) {
+        total_bytes += e.bytes;
+        total_objects += e.objects;
+    }
+
+    std::fprintf(
+            out,
+            "Heap profile: %" PRIu64 " bytes in %" PRIu64 " objects at %zu sites\n"
+            "%14s %12s %7s  %s\n",
+            total_bytes, total_objects, es.size(),
+            "bytes", "objects", "%", "site"
+        );
+
+    for (auto const& e : es) {
+        std::fprintf(
+                out,
+                "%14" PRIu64 " %12" PRIu64 " %6.2f%%  %s\n",
+                e.bytes,
+                e.objects,
+                total_bytes == 0u ? 0.0 : 100.0 * e.bytes / total_bytes,
+                e.site.c_str()
+            );
+    }
+}
+
+heap_profile &global_heap_profile()
+{
+    // Note:
+    // Never destroyed because allocations may happen in other threads at exit.
+    static auto *const p = new heap_profile;
+    return *p;
+}
+
+void report_heap_profile_at_exit()
+{
+    std::atexit([]{ global_heap_profile().report(stderr); });
+}
+
+} // namespace runtime
+} // namespace dachs
@@ -0,0 +1,57 @@
+#if !defined DACHS_RUNTIME_HEAP_PROFILE_HPP_INCLUDED
+#define      DACHS_RUNTIME_HEAP_PROFILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Allocation counts per allocation site.  It is used by executables compiled
+// with --heap-profile.  A site is a string literal like "foo.dcs:12:5" emitted
+// by the compiler, so its address identifies the site in a module.
+class heap_profile {
+public:
+    struct entry {
+        std::string site;
+        std::uint64_t bytes;
+        std::uint64_t objects;
+    };
+
+private:
+    struct counts {
+        std::uint64_t bytes = 0u;
+        std::uint64_t objects = 0u;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<char const*, counts> sites;
+
+public:
+
+    void record(char const* const site, std::size_t const bytes);
+
+    // Note:
+    // Sites which have the same name in different modules are merged.
+    // Sorted by bytes and then by objects in descending order.
+    std::vector<entry> entries();
+
+    void report(std::FILE *const out);
+};
+
+heap_profile &global_heap_profile();
+
+// Note:
+// Report the global heap profile to stderr at exit.
+void report_heap_profile_at_exit();
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_HEAP_PROFILE_HPP_INCLUDED
@@ -0,0 +1,154 @@
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+
+#include "dachs/io.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+inline bool is_space(char const c) noexcept
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+} // namespace detail
+
+input_buffer::input_buffer(int const f, std::size_t const initial_capacity)
+    : fd(f), buf(initial_capacity == 0u ? 1u : initial_capacity)
+{}
+
+bool input_buffer::fill() noexcept
+{
+    if (reached_eof) {
+        return false;
+    }
+
+    if (begin != 0u) {
+        std::memmove(buf.data(), buf.data() + begin, end - begin);
+        end -= begin;
+        begin = 0u;
+    }
+
+    if (end == buf.size()) {
+        // Note:
+        // A line or a token is longer than the buffer
+        try {
+            buf.resize(buf.size() * 2u);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    for (;;) {
+        auto const read_size = ::read(fd, buf.data() + end, buf.size() - end);
+        if (read_size > 0) {
+            end += static_cast<std::size_t>(read_size);
+            return true;
+        } else if (read_size < 0 && errno == EINTR) {
+            continue;
+        } else {
+            reached_eof = true;
+            return false;
+        }
+    }
+}
+
+bool input_buffer::read_line(char const*& data, std::size_t &size) noexcept
+{
+    std::size_t scanned = 0u;
+
+    for (;;) {
+        auto const* const head = buf.data() + begin;
+        auto const* const newline = static_cast<char const*>(std::memchr(head + scanned, '\n', end - begin - scanned));
+
+        if (newline) {
+            data = head;
+            size = static_cast<std::size_t>(newline - head);
+            begin += size + 1u;
+            return true;
+        }
+
+        scanned = end - begin;
+
+        if (!fill()) {
+            if (begin == end) {
+                return false;
+            }
+
+            // Note:
+            // The last line without '\n'
+            data = buf.data() + begin;
+            size = end - begin;
+            begin = end;
+            return true;
+        }
+    }
+}
+
+bool input_buffer::read_token(char const*& data, std::size_t &size) noexcept
+{
+    for (;;) {
+        while (begin != end && detail::is_space(buf[begin])) {
+            ++begin;
+        }
+
+        if (begin != end) {
+            break;
+        }
+
+        if (!fill()) {
+            return false;
+        }
+    }
+
+    std::size_t len = 0u;
+    for (;;) {
+        while (begin + len != end && !detail::is_space(buf[begin + len])) {
+            ++len;
+        }
+
+        if (begin + len != end || !fill()) {
+            break;
+        }
+    }
+
+    data = buf.data() + begin;
+    size = len;
+    begin += len;
+    return true;
+}
+
+void input_buffer::read_all(char const*& data, std::size_t &size) noexcept
+{
+    while (fill()) {}
+
+    data = buf.data() + begin;
+    size = end - begin;
+    begin = end;
+}
+
+int input_buffer::read_char() noexcept
+{
+    if (begin == end && !fill()) {
+        return -1;
+    }
+
+    return static_cast<unsigned char>(buf[begin++]);
+}
+
+bool input_buffer::eof() noexcept
+{
+    return begin == end && !fill();
+}
+
+input_buffer &stdin_buffer()
+{
+    static input_buffer buffer{STDIN_FILENO};
+    return buffer;
+}
+
+} // namespace runtime
+} // namespace dachs
@@ -0,0 +1,56 @@
+#if !defined DACHS_RUNTIME_IO_HPP_INCLUDED
+#define      DACHS_RUNTIME_IO_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Buffered reader over a file descriptor.  Reading functions return views
+// over the internal buffer.  They are valid until the next read.
+class input_buffer {
+    int const fd;
+    std::vector<char> buf;
+    std::size_t begin = 0u;
+    std::size_t end = 0u;
+    bool reached_eof = false;
+
+    // Note:
+    // Read more bytes after the unread ones.  Return false when no byte is read.
+    bool fill() noexcept;
+
+public:
+
+    explicit input_buffer(int const fd, std::size_t const initial_capacity = 64u * 1024u);
+
+    input_buffer(input_buffer const&) = delete;
+    input_buffer &operator=(input_buffer const&) = delete;
+
+    // Note:
+    // The line terminator '\n' is not included.  Return false at EOF.
+    bool read_line(char const*& data, std::size_t &size) noexcept;
+
+    // Note:
+    // Skip white spaces and read a sequence of non white space characters.
+    // Return false when no token remains.
+    bool read_token(char const*& data, std::size_t &size) noexcept;
+
+    // Note:
+    // Read all remaining bytes.  'size' is 0 at EOF.
+    void read_all(char const*& data, std::size_t &size) noexcept;
+
+    // Note:
+    // Return -1 at EOF
+    int read_char() noexcept;
+
+    bool eof() noexcept;
+};
+
+input_buffer &stdin_buffer();
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_IO_HPP_INCLUDED
@@ -0,0 +1,41 @@
+#if !defined DACHS_RUNTIME_NUMBER_HPP_INCLUDED
+#define      DACHS_RUNTIME_NUMBER_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstddef>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Enough for the longest output of format_float(), e.g. "-2.2250738585072014e-308"
+std::size_t const max_float_length = 32u;
+
+// Note:
+// Length of the textual representation of the number in the base (2..36).
+// The sign is included for signed integers.
+std::size_t uint_length(std::uint64_t const u, std::uint64_t const base) noexcept;
+std::size_t int_length(std::int64_t const i, std::uint64_t const base) noexcept;
+
+// Note:
+// Write the number to 'buf' and return the number of written characters.
+// '\0' is not appended.  'buf' must have enough space for *_length() characters.
+std::size_t format_uint(char *const buf, std::uint64_t const u, std::uint64_t const base) noexcept;
+std::size_t format_int(char *const buf, std::int64_t const i, std::uint64_t const base) noexcept;
+
+// Note:
+// Write the shortest representation which is read back to the same double (Ryu algorithm).
+// 'buf' must have max_float_length characters at least.
+std::size_t format_float(char *const buf, double const d) noexcept;
+
+// Note:
+// Parse the whole range [s, s+size).  Return false on a malformed string or an overflow.
+// parse_float() accepts "inf" and "nan" but rejects finite numbers out of the range
+// of double (e.g. "1e400").  Too small numbers are rounded to zero.
+bool parse_int(char const* const s, std::size_t const size, std::uint64_t const base, std::int64_t &out) noexcept;
+bool parse_float(char const* const s, std::size_t const size, double &out) noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_NUMBER_HPP_INCLUDED
@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+
+#include "dachs/pgo_profile.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+struct pgo_counters {
+    char const* name;
+    std::uint64_t checksum;
+    std::uint64_t size;
+    std::uint64_t const* counters;
+};
+
+// Note:
+// Never destroyed because it is read at exit.
+struct pgo_registry {
+    std::mutex mutex;
+    std::map<std::string, std::vector<pgo_counters>> files;
+};
+
+pgo_registry &get_pgo_registry()
+{
+    static auto *const r = new pgo_registry;
+    return *r;
+}
+
+void write_pgo_profiles()
+{
+    auto &r = get_pgo_registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+
+    for (auto const& f : r.files) {
+        pgo_profile profile;
+        {
+            std::ifstream in{f.first};
+            if (in && !profile.read(in)) {
+                std::fprintf(stderr, "Profile '%s' is broken.  It is overwritten.\n", f.first.c_str());
+                profile.functions.clear();
+            }
+        }
+
+        pgo_profile current;
+        for (auto const& c : f.second) {
+            auto &f = current.functions[c.name];
+            f.checksum = c.checksum;
+            f.counts.assign(c.counters, c.counters + c.size);
+        }
+        profile.merge(current);
+
+        std::ofstream out{f.first};
+        if (!out) {
+            std::fprintf(stderr, "Failed to write profile '%s'\n", f.first.c_str());
+            continue;
+        }
+        profile.write(out);
+    }
+}
+
+} // namespace detail
+
+void register_pgo_counters(char const* const file, char const* const name, std::uint64_t const checksum, std::uint64_t const size, std::uint64_t const* const counters)
+{
+    auto &r = detail::get_pgo_registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+
+    if (r.files.empty()) {
+        std::atexit(detail::write_pgo_profiles);
+    }
+    r.files[file].push_back({name, checksum, size, counters});
+}
+
+} // namespace runtime
+} // namespace dachs
@@ -0,0 +1,121 @@
+#if !defined DACHS_RUNTIME_PGO_PROFILE_HPP_INCLUDED
+#define      DACHS_RUNTIME_PGO_PROFILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Counters of profile guided optimization.  Executables compiled with
+// --profile-generate write it at exit and the compiler reads it with
+// --profile-use.  It is shared by the runtime and the compiler, so the
+// format is defined only here.
+//
+//   dachs-profile 2
+//   {checksum} {number of counters} {counter}... {function name}
+//
+// A function name is the last field because it contains spaces.  A checksum
+// is computed from the control flow of the function by the compiler.  Counts
+// of a function are used only when both its checksum and its number of
+// counters match because the function may be changed after the profile was
+// generated.
+struct pgo_profile {
+    struct function {
+        std::uint64_t checksum = 0u;
+        std::vector<std::uint64_t> counts;
+
+        bool matches(std::uint64_t const c, std::size_t const size) const noexcept
+        {
+            return checksum == c && counts.size() == size;
+        }
+
+        bool operator==(function const& rhs) const noexcept
+        {
+            return checksum == rhs.checksum && counts == rhs.counts;
+        }
+    };
+
+    std::map<std::string, function> functions;
+
+    bool read(std::istream &in)
+    {
+        std::string magic;
+        unsigned version = 0u;
+        if (!(in >> magic >> version) || magic != "dachs-profile" || version != 2u) {
+            return false;
+        }
+
+        std::uint64_t checksum;
+        while (in >> checksum) {
+            std::size_t size;
+            if (!(in >> size)) {
+                return false;
+            }
+
+            std::vector<std::uint64_t> counts(size);
+            for (auto &c : counts) {
+                if (!(in >> c)) {
+                    return false;
+                }
+            }
+
+            std::string name;
+            in.get();
+            if (!std::getline(in, name) || name.empty()) {
+                return false;
+            }
+
+            functions[name] = {checksum, std::move(counts)};
+        }
+
+        return in.eof();
+    }
+
+    void write(std::ostream &out) const
+    {
+        out << "dachs-profile 2\n";
+        for (auto const& f : functions) {
+            out << f.second.checksum << ' ' << f.second.counts.size();
+            for (auto const n : f.second.counts) {
+                out << ' ' << n;
+            }
+            out << ' ' << f.first << '\n';
+        }
+    }
+
+    // Note:
+    // Counts of the same function are summed up over runs.  When the checksum
+    // or the number of counters differs, the function was changed and the old
+    // counts are replaced.
+    void merge(pgo_profile const& other)
+    {
+        for (auto const& f : other.functions) {
+            auto &mine = functions[f.first];
+            if (!mine.matches(f.second.checksum, f.second.counts.size())) {
+                mine = f.second;
+                continue;
+            }
+            for (std::size_t i = 0u; i < mine.counts.size(); ++i) {
+                mine.counts[i] += f.second.counts[i];
+            }
+        }
+    }
+};
+
+// Note:
+// Register counters of a function.  They are merged into 'file' at exit.
+// Counters are incremented by compiled code without synchronization, so
+// counts of functions executed in multiple threads may be slightly lost.
+void register_pgo_counters(char const* const file, char const* const name, std::uint64_t const checksum, std::uint64_t const size, std::uint64_t const* const counters);
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_PGO_PROFILE_HPP_INCLUDED
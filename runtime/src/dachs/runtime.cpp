@@ -3,8 +3,96 @@
 #include <cstdarg>
 #include <cstdlib>
 #include <cstring>
+#include <new>
+#include <stdexcept>
+#include <atomic>
+#include <chrono>
+
+#include <gc.h>
 
 #include "dachs/runtime.hpp"
+#include "dachs/number.hpp"
+#include "dachs/io.hpp"
+#include "dachs/file.hpp"
+#include "dachs/task.hpp"
+#include "dachs/channel.hpp"
+#include "dachs/gc.hpp"
+#include "dachs/heap_profile.hpp"
+#include "dachs/function_profile.hpp"
+#include "dachs/pgo_profile.hpp"
+#include "dachs/arena.hpp"
+#include "dachs/alloc_cache.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+// Note:
+// Characters are never scanned by GC.  '\0' is appended for C functions.
+inline char *copy_to_gc_string(char const* const data, std::size_t const size)
+{
+    auto *const s = static_cast<char *>(GC_MALLOC_ATOMIC(size + 1u));
+    std::memcpy(s, data, size);
+    s[size] = '\0';
+    return s;
+}
+
+// Note:
+// Buffers of strings have no pointer, so GC doesn't scan them.
+inline void *gc_realloc_atomic(void *const ptr, std::size_t const size)
+{
+    return ptr ? GC_realloc(ptr, size) : GC_malloc_atomic(size);
+}
+
+inline file *file_of(std::uint64_t const handle) noexcept
+{
+    return reinterpret_cast<file *>(handle);
+}
+
+inline task *task_of(std::uint64_t const handle) noexcept
+{
+    return reinterpret_cast<task *>(handle);
+}
+
+inline bounded_ring *ring_of(std::uint64_t const handle) noexcept
+{
+    return reinterpret_cast<bounded_ring *>(handle);
+}
+
+inline spsc_queue *spsc_of(std::uint64_t const handle) noexcept
+{
+    return reinterpret_cast<spsc_queue *>(handle);
+}
+
+inline void *gc_alloc(std::size_t const size)
+{
+    return GC_MALLOC(size);
+}
+
+inline arena *arena_of(std::uint64_t const handle) noexcept
+{
+    return reinterpret_cast<arena *>(handle);
+}
+
+// Note:
+// C++ exceptions must not propagate to Dachs code.  Errors of the task scheduler
+// (e.g. failure to create worker threads) are reported as fatal errors.
+template<class Func>
+auto fatal_on_error(Func const& func) -> decltype(func())
+{
+    try {
+        return func();
+    } catch (std::bad_alloc const&) {
+        __dachs_fatal_reason__("out of memory in task scheduler");
+    } catch (std::runtime_error const& e) {
+        __dachs_fatal_reason__(e.what());
+    }
+    std::abort(); // Not reached.  __dachs_fatal_reason__() aborts.
+}
+
+} // namespace detail
+} // namespace runtime
+} // namespace dachs
 
 extern "C" {
     std::uint64_t __dachs_gen_symbol__(char const* const s, std::uint64_t const size)
@@ -82,6 +170,66 @@ extern "C" {
         std::printf("%s", b ? "true" : "false");
     }
 
+    void __dachs_println_i8__(std::int8_t const i)
+    {
+        std::printf("%d\n", static_cast<int>(i));
+    }
+
+    void __dachs_println_i16__(std::int16_t const i)
+    {
+        std::printf("%d\n", static_cast<int>(i));
+    }
+
+    void __dachs_println_i32__(std::int32_t const i)
+    {
+        std::printf("%d\n", static_cast<int>(i));
+    }
+
+    void __dachs_println_u8__(std::uint8_t const u)
+    {
+        std::printf("%u\n", static_cast<unsigned int>(u));
+    }
+
+    void __dachs_println_u32__(std::uint32_t const u)
+    {
+        std::printf("%u\n", static_cast<unsigned int>(u));
+    }
+
+    void __dachs_println_f32__(float const f)
+    {
+        std::printf("%g\n", static_cast<double>(f));
+    }
+
+    void __dachs_print_i8__(std::int8_t const i)
+    {
+        std::printf("%d", static_cast<int>(i));
+    }
+
+    void __dachs_print_i16__(std::int16_t const i)
+    {
+        std::printf("%d", static_cast<int>(i));
+    }
+
+    void __dachs_print_i32__(std::int32_t const i)
+    {
+        std::printf("%d", static_cast<int>(i));
+    }
+
+    void __dachs_print_u8__(std::uint8_t const u)
+    {
+        std::printf("%u", static_cast<unsigned int>(u));
+    }
+
+    void __dachs_print_u32__(std::uint32_t const u)
+    {
+        std::printf("%u", static_cast<unsigned int>(u));
+    }
+
+    void __dachs_print_f32__(float const f)
+    {
+        std::printf("%g", static_cast<double>(f));
+    }
+
     void __dachs_printf__(char const* const fmt, ...)
     {
         va_list l;
@@ -90,9 +238,11 @@ extern "C" {
         va_end(l);
     }
 
+    // Note:
+    // Read via the same buffer as other input functions not to mix up the order
     char __dachs_getchar__()
     {
-        return std::getchar();
+        return static_cast<char>(dachs::runtime::stdin_buffer().read_char());
     }
 
     void __dachs_fatal__()
@@ -105,4 +255,461 @@ extern "C" {
         std::fprintf(stderr, "Reason: %s\n", reason);
         std::abort();
     }
+
+    // Note:
+    // Nanoseconds from an unspecified point.  It never goes backward, so it is
+    // suitable only for measuring elapsed time.
+    std::uint64_t __dachs_monotonic_ns__()
+    {
+        return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+                ).count()
+            );
+    }
+
+    std::uint64_t __dachs_int_length__(std::int64_t const i, std::uint64_t const base)
+    {
+        return dachs::runtime::int_length(i, base);
+    }
+
+    std::uint64_t __dachs_uint_length__(std::uint64_t const u, std::uint64_t const base)
+    {
+        return dachs::runtime::uint_length(u, base);
+    }
+
+    std::uint64_t __dachs_format_int__(char *const buf, std::int64_t const i, std::uint64_t const base)
+    {
+        return dachs::runtime::format_int(buf, i, base);
+    }
+
+    std::uint64_t __dachs_format_uint__(char *const buf, std::uint64_t const u, std::uint64_t const base)
+    {
+        return dachs::runtime::format_uint(buf, u, base);
+    }
+
+    std::uint64_t __dachs_format_float__(char *const buf, double const d)
+    {
+        return dachs::runtime::format_float(buf, d);
+    }
+
+    bool __dachs_parse_int__(char const* const s, std::uint64_t const size, std::uint64_t const base, std::int64_t *const out)
+    {
+        return dachs::runtime::parse_int(s, size, base, *out);
+    }
+
+    bool __dachs_parse_float__(char const* const s, std::uint64_t const size, double *const out)
+    {
+        return dachs::runtime::parse_float(s, size, *out);
+    }
+
+    char *__dachs_read_line__(std::uint64_t *const size)
+    {
+        char const* data;
+        std::size_t s;
+        if (!dachs::runtime::stdin_buffer().read_line(data, s)) {
+            *size = 0u;
+            return nullptr;
+        }
+        *size = s;
+        return dachs::runtime::detail::copy_to_gc_string(data, s);
+    }
+
+    char *__dachs_read_token__(std::uint64_t *const size)
+    {
+        char const* data;
+        std::size_t s;
+        if (!dachs::runtime::stdin_buffer().read_token(data, s)) {
+            *size = 0u;
+            return nullptr;
+        }
+        *size = s;
+        return dachs::runtime::detail::copy_to_gc_string(data, s);
+    }
+
+    char *__dachs_read_all__(std::uint64_t *const size)
+    {
+        char const* data;
+        std::size_t s;
+        dachs::runtime::stdin_buffer().read_all(data, s);
+        *size = s;
+        return dachs::runtime::detail::copy_to_gc_string(data, s);
+    }
+
+    std::int64_t __dachs_read_char__()
+    {
+        return dachs::runtime::stdin_buffer().read_char();
+    }
+
+    bool __dachs_stdin_eof__()
+    {
+        return dachs::runtime::stdin_buffer().eof();
+    }
+
+    // Note:
+    // File handle is an address of dachs::runtime::file.  0 means failure.
+    std::uint64_t __dachs_file_open__(char const* const path, char const* const mode)
+    {
+        return reinterpret_cast<std::uint64_t>(dachs::runtime::file::open(path, mode));
+    }
+
+    bool __dachs_file_close__(std::uint64_t const handle)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        if (!f) {
+            return false;
+        }
+        auto const closed = f->close();
+        delete f;
+        return closed;
+    }
+
+    bool __dachs_file_write__(std::uint64_t const handle, char const* const data, std::uint64_t const size)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        return f && f->write(data, size);
+    }
+
+    bool __dachs_file_flush__(std::uint64_t const handle)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        return f && f->flush();
+    }
+
+    std::uint64_t __dachs_file_read__(std::uint64_t const handle, char *const buf, std::uint64_t const size)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        return f ? f->read(buf, size) : 0u;
+    }
+
+    char *__dachs_file_read_all__(std::uint64_t const handle, std::uint64_t *const size)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        std::size_t s = 0u;
+        auto *const data = f ? f->read_all(s, dachs::runtime::detail::gc_realloc_atomic) : nullptr;
+        *size = s;
+        return data ? data : dachs::runtime::detail::copy_to_gc_string("", 0u);
+    }
+
+    std::int64_t __dachs_file_size__(std::uint64_t const handle)
+    {
+        auto *const f = dachs::runtime::detail::file_of(handle);
+        return f ? f->size() : -1;
+    }
+
+    char *__dachs_mmap_read__(char const* const path, std::uint64_t *const size)
+    {
+        dachs::runtime::mapped_region region;
+        if (!dachs::runtime::map_file(path, region)) {
+            *size = 0u;
+            return nullptr;
+        }
+        *size = region.size;
+        return const_cast<char *>(region.data);
+    }
+
+    bool __dachs_munmap__(char *const data, std::uint64_t const size)
+    {
+        dachs::runtime::mapped_region region;
+        region.data = data;
+        region.size = size;
+        return dachs::runtime::unmap_file(region);
+    }
+
+    // Note:
+    // Copy the line which starts at *pos and advance *pos to the next line.
+    // Return nullptr when *pos reaches the end.
+    char *__dachs_next_line__(char const* const data, std::uint64_t const size, std::uint64_t *const pos, std::uint64_t *const line_size)
+    {
+        if (*pos >= size) {
+            *line_size = 0u;
+            return nullptr;
+        }
+
+        auto const* const head = data + *pos;
+        auto const rest = size - *pos;
+        auto const* const newline = static_cast<char const*>(std::memchr(head, '\n', rest));
+        auto const len = newline ? static_cast<std::uint64_t>(newline - head) : rest;
+
+        *pos += newline ? len + 1u : len;
+        *line_size = len;
+        return dachs::runtime::detail::copy_to_gc_string(head, len);
+    }
+
+    std::uint64_t __dachs_task_spawn__(void (*const func)(void *), void *const env)
+    {
+        return dachs::runtime::detail::fatal_on_error(
+                [func, env]{ return reinterpret_cast<std::uint64_t>(dachs::runtime::global_scheduler().spawn(func, env)); }
+            );
+    }
+
+    void __dachs_task_join__(std::uint64_t const handle)
+    {
+        dachs::runtime::detail::fatal_on_error(
+                [handle]{ dachs::runtime::global_scheduler().join(dachs::runtime::detail::task_of(handle)); }
+            );
+    }
+
+    std::uint64_t __dachs_num_workers__()
+    {
+        return dachs::runtime::detail::fatal_on_error(
+                []{ return static_cast<std::uint64_t>(dachs::runtime::global_scheduler().num_workers()); }
+            );
+    }
+
+    // Note:
+    // A ring and its sequence numbers are allocated in one block.  The block contains no
+    // pointer to GC objects.  It is kept alive while a Dachs object holds the handle
+    // because GC scans Dachs objects conservatively.
+    std::uint64_t __dachs_ring_new__(std::uint64_t const capacity)
+    {
+        using dachs::runtime::bounded_ring;
+        using sequence_type = std::atomic<std::uint64_t>;
+
+        auto const c = bounded_ring::round_capacity(capacity);
+        auto *const mem = static_cast<char *>(GC_MALLOC_ATOMIC(sizeof(bounded_ring) + c * sizeof(sequence_type)));
+        auto *const sequences = new (mem + sizeof(bounded_ring)) sequence_type[c];
+        return reinterpret_cast<std::uint64_t>(new (mem) bounded_ring{sequences, c});
+    }
+
+    std::uint64_t __dachs_ring_capacity__(std::uint64_t const ring)
+    {
+        return dachs::runtime::detail::ring_of(ring)->capacity();
+    }
+
+    std::uint64_t __dachs_ring_size__(std::uint64_t const ring)
+    {
+        return dachs::runtime::detail::ring_of(ring)->size();
+    }
+
+    // Note:
+    // Try-claim functions return a ticket, which is the claimed position plus 1.
+    // 0 means the ring is full (or empty).  Dachs code needs no out-parameter then.
+    std::uint64_t __dachs_ring_try_claim_push__(std::uint64_t const ring)
+    {
+        std::uint64_t pos;
+        return dachs::runtime::detail::ring_of(ring)->try_claim_push(pos) ? pos + 1u : 0u;
+    }
+
+    std::uint64_t __dachs_ring_claim_push__(std::uint64_t const ring)
+    {
+        return dachs::runtime::detail::ring_of(ring)->claim_push();
+    }
+
+    void __dachs_ring_publish_push__(std::uint64_t const ring, std::uint64_t const pos)
+    {
+        dachs::runtime::detail::ring_of(ring)->publish_push(pos);
+    }
+
+    std::uint64_t __dachs_ring_try_claim_pop__(std::uint64_t const ring)
+    {
+        std::uint64_t pos;
+        return dachs::runtime::detail::ring_of(ring)->try_claim_pop(pos) ? pos + 1u : 0u;
+    }
+
+    std::uint64_t __dachs_ring_claim_pop__(std::uint64_t const ring)
+    {
+        return dachs::runtime::detail::ring_of(ring)->claim_pop();
+    }
+
+    void __dachs_ring_release_pop__(std::uint64_t const ring, std::uint64_t const pos)
+    {
+        dachs::runtime::detail::ring_of(ring)->release_pop(pos);
+    }
+
+    std::uint64_t __dachs_spsc_new__()
+    {
+        auto *const mem = GC_MALLOC(sizeof(dachs::runtime::spsc_queue));
+        return reinterpret_cast<std::uint64_t>(new (mem) dachs::runtime::spsc_queue{dachs::runtime::detail::gc_alloc});
+    }
+
+    void __dachs_spsc_push__(std::uint64_t const queue, void *const box)
+    {
+        dachs::runtime::detail::spsc_of(queue)->push(box);
+    }
+
+    bool __dachs_spsc_try_pop__(std::uint64_t const queue, void **const out)
+    {
+        return dachs::runtime::detail::spsc_of(queue)->try_pop(*out);
+    }
+
+    void *__dachs_spsc_pop__(std::uint64_t const queue)
+    {
+        return dachs::runtime::detail::spsc_of(queue)->pop();
+    }
+
+    bool __dachs_spsc_empty__(std::uint64_t const queue)
+    {
+        return dachs::runtime::detail::spsc_of(queue)->empty();
+    }
+
+    // Note:
+    // Called at the beginning of the entry point instead of GC_init().
+    // Arguments are set by compiler flags.  Environment variables override them.
+    void __dachs_gc_init__(
+            std::uint64_t const markers,
+            bool const incremental,
+            std::uint64_t const initial_heap_size,
+            std::uint64_t const free_space_divisor)
+    {
+        dachs::runtime::gc_config config;
+        config.markers = markers;
+        config.incremental = incremental;
+        config.initial_heap_size = initial_heap_size;
+        config.free_space_divisor = free_space_divisor;
+        dachs::runtime::init_gc(dachs::runtime::gc_config_from_env(config));
+    }
+
+    bool __dachs_gc_expand_heap__(std::uint64_t const bytes)
+    {
+        return GC_expand_hp(bytes) != 0;
+    }
+
+    // Note:
+    // Store heap size, bytes allocated since the last GC, the number of collections
+    // and total pause time in nanoseconds in this order.
+    void __dachs_gc_stats__(std::uint64_t *const out)
+    {
+        auto const stats = dachs::runtime::get_gc_stats();
+        out[0] = stats.heap_size;
+        out[1] = stats.bytes_since_gc;
+        out[2] = stats.collections;
+        out[3] = stats.pause_time_ns;
+    }
+
+    // Note:
+    // Allocation functions of executables compiled with --heap-profile.
+    // 'site' is a string literal which represents the allocating source location.
+    void __dachs_heap_profile_init__()
+    {
+        dachs::runtime::report_heap_profile_at_exit();
+    }
+
+    void *__dachs_profiled_malloc__(std::size_t const size, char const* const site)
+    {
+        dachs::runtime::global_heap_profile().record(site, size);
+        return __dachs_malloc__(size);
+    }
+
+    // Note:
+    // Called by executables compiled with --profile-functions.  A module
+    // constructor registers the names of the instrumented functions and each
+    // function passes its slot at its entry.
+    void __dachs_function_profile_init__()
+    {
+        dachs::runtime::report_function_profile_at_exit();
+    }
+
+    std::uint64_t __dachs_function_profile_register__(char const* const* const names, std::uint64_t const size)
+    {
+        return dachs::runtime::register_profiled_functions(names, size);
+    }
+
+    void __dachs_function_enter__(std::uint64_t const slot)
+    {
+        dachs::runtime::thread_function_profile().enter(slot, dachs::runtime::read_cycle_counter());
+    }
+
+    void __dachs_function_exit__()
+    {
+        dachs::runtime::thread_function_profile().exit(dachs::runtime::read_cycle_counter());
+    }
+
+    // Note:
+    // Called from module constructors of executables compiled with --profile-generate.
+    void __dachs_pgo_register__(char const* const file, char const* const name, std::uint64_t const checksum, std::uint64_t const size, std::uint64_t *const counters)
+    {
+        dachs::runtime::register_pgo_counters(file, name, checksum, size, counters);
+    }
+
+    // Note:
+    // Allocation functions called by compiled code.  Objects are allocated in
+    // the current arena of the thread if set.  Otherwise in GC heap.
+    // Returned memory must be zero-cleared because compiled code doesn't clear it.
+    void *__dachs_malloc__(std::size_t const size)
+    {
+        if (auto *const a = dachs::runtime::current_arena()) {
+            if (auto *const p = a->allocate(size)) {
+                return p;
+            }
+        }
+        return GC_malloc(size);
+    }
+
+    // Note:
+    // Fast path for objects of a fixed size which is not greater than
+    // alloc_cache_max_size.  It doesn't take the allocation lock of GC in most cases.
+    void *__dachs_malloc_small__(std::size_t const size)
+    {
+        if (auto *const a = dachs::runtime::current_arena()) {
+            if (auto *const p = a->allocate(size)) {
+                return p;
+            }
+        }
+        return dachs::runtime::cached_alloc(size);
+    }
+
+    // Note:
+    // An object in an arena is an interior pointer of a chunk, which is a GC
+    // object.  So GC_base() distinguishes it from a GC object and from memory
+    // which GC doesn't know (e.g. global constant strings or mmap'd buffers).
+    // The latter can't be reallocated because their sizes are unknown.  The
+    // header of an object in an arena holds its size and its arena, and the
+    // object is reallocated in the same arena.
+    void *__dachs_realloc__(void *const ptr, std::size_t const size)
+    {
+        auto *const base = ptr ? GC_base(ptr) : nullptr;
+        if (!ptr || base == ptr) {
+            return GC_realloc(ptr, size);
+        }
+
+        if (!base) {
+            __dachs_fatal_reason__("realloc() of memory which is not allocated by GC or an arena");
+        }
+
+        auto const old_size = dachs::runtime::arena::size_of(ptr);
+        auto *new_ptr = dachs::runtime::arena::owner_of(ptr)->allocate(size);
+        if (!new_ptr) {
+            new_ptr = GC_malloc(size);
+        }
+        std::memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+        return new_ptr;
+    }
+
+    // Note:
+    // Objects in an arena are freed only by releasing the arena.
+    void __dachs_free__(void *const ptr)
+    {
+        if (GC_base(ptr) == ptr) {
+            GC_free(ptr);
+        }
+    }
+
+    // Note:
+    // An arena is a GC object because its chunks must be scanned.  It is kept alive
+    // while a Dachs object holds the handle.  0 for 'chunk_size' means the default size.
+    std::uint64_t __dachs_arena_new__(std::uint64_t const chunk_size)
+    {
+        auto *const mem = GC_MALLOC(sizeof(dachs::runtime::arena));
+        return reinterpret_cast<std::uint64_t>(new (mem) dachs::runtime::arena{dachs::runtime::detail::gc_alloc, chunk_size});
+    }
+
+    // Note:
+    // 0 means GC heap.  Return the handle of the previous arena.
+    std::uint64_t __dachs_arena_switch__(std::uint64_t const arena)
+    {
+        return reinterpret_cast<std::uint64_t>(
+                dachs::runtime::switch_arena(dachs::runtime::detail::arena_of(arena))
+            );
+    }
+
+    void __dachs_arena_release__(std::uint64_t const arena)
+    {
+        dachs::runtime::detail::arena_of(arena)->release();
+    }
+
+    std::uint64_t __dachs_arena_allocated__(std::uint64_t const arena)
+    {
+        return dachs::runtime::detail::arena_of(arena)->allocated_bytes();
+    }
 }
@@ -227,10 +227,80 @@ extern "C" {
     void __dachs_print_string__(char const* const s);
     void __dachs_print_symbol__(std::uint64_t const s);
     void __dachs_print_bool__(bool const b);
+    void __dachs_println_i8__(std::int8_t const i);
+    void __dachs_println_i16__(std::int16_t const i);
+    void __dachs_println_i32__(std::int32_t const i);
+    void __dachs_println_u8__(std::uint8_t const u);
+    void __dachs_println_u32__(std::uint32_t const u);
+    void __dachs_println_f32__(float const f);
+    void __dachs_print_i8__(std::int8_t const i);
+    void __dachs_print_i16__(std::int16_t const i);
+    void __dachs_print_i32__(std::int32_t const i);
+    void __dachs_print_u8__(std::uint8_t const u);
+    void __dachs_print_u32__(std::uint32_t const u);
+    void __dachs_print_f32__(float const f);
     void __dachs_printf__(char const* const fmt, ...);
     char __dachs_getchar__();
     void __dachs_fatal__();
     void __dachs_fatal_reason__(char const* const reason);
+    std::uint64_t __dachs_monotonic_ns__();
+    std::uint64_t __dachs_int_length__(std::int64_t const i, std::uint64_t const base);
+    std::uint64_t __dachs_uint_length__(std::uint64_t const u, std::uint64_t const base);
+    std::uint64_t __dachs_format_int__(char *const buf, std::int64_t const i, std::uint64_t const base);
+    std::uint64_t __dachs_format_uint__(char *const buf, std::uint64_t const u, std::uint64_t const base);
+    std::uint64_t __dachs_format_float__(char *const buf, double const d);
+    bool __dachs_parse_int__(char const* const s, std::uint64_t const size, std::uint64_t const base, std::int64_t *const out);
+    bool __dachs_parse_float__(char const* const s, std::uint64_t const size, double *const out);
+    char *__dachs_read_line__(std::uint64_t *const size);
+    char *__dachs_read_token__(std::uint64_t *const size);
+    char *__dachs_read_all__(std::uint64_t *const size);
+    std::int64_t __dachs_read_char__();
+    bool __dachs_stdin_eof__();
+    std::uint64_t __dachs_file_open__(char const* const path, char const* const mode);
+    bool __dachs_file_close__(std::uint64_t const handle);
+    bool __dachs_file_write__(std::uint64_t const handle, char const* const data, std::uint64_t const size);
+    bool __dachs_file_flush__(std::uint64_t const handle);
+    std::uint64_t __dachs_file_read__(std::uint64_t const handle, char *const buf, std::uint64_t const size);
+    char *__dachs_file_read_all__(std::uint64_t const handle, std::uint64_t *const size);
+    std::int64_t __dachs_file_size__(std::uint64_t const handle);
+    char *__dachs_mmap_read__(char const* const path, std::uint64_t *const size);
+    bool __dachs_munmap__(char *const data, std::uint64_t const size);
+    char *__dachs_next_line__(char const* const data, std::uint64_t const size, std::uint64_t *const pos, std::uint64_t *const line_size);
+    std::uint64_t __dachs_task_spawn__(void (*const func)(void *), void *const env);
+    void __dachs_task_join__(std::uint64_t const handle);
+    std::uint64_t __dachs_num_workers__();
+    std::uint64_t __dachs_ring_new__(std::uint64_t const capacity);
+    std::uint64_t __dachs_ring_capacity__(std::uint64_t const ring);
+    std::uint64_t __dachs_ring_size__(std::uint64_t const ring);
+    std::uint64_t __dachs_ring_try_claim_push__(std::uint64_t const ring);
+    std::uint64_t __dachs_ring_claim_push__(std::uint64_t const ring);
+    void __dachs_ring_publish_push__(std::uint64_t const ring, std::uint64_t const pos);
+    std::uint64_t __dachs_ring_try_claim_pop__(std::uint64_t const ring);
+    std::uint64_t __dachs_ring_claim_pop__(std::uint64_t const ring);
+    void __dachs_ring_release_pop__(std::uint64_t const ring, std::uint64_t const pos);
+    std::uint64_t __dachs_spsc_new__();
+    void __dachs_spsc_push__(std::uint64_t const queue, void *const box);
+    bool __dachs_spsc_try_pop__(std::uint64_t const queue, void **const out);
+    void *__dachs_spsc_pop__(std::uint64_t const queue);
+    bool __dachs_spsc_empty__(std::uint64_t const queue);
+    void __dachs_gc_init__(std::uint64_t const markers, bool const incremental, std::uint64_t const initial_heap_size, std::uint64_t const free_space_divisor);
+    bool __dachs_gc_expand_heap__(std::uint64_t const bytes);
+    void __dachs_gc_stats__(std::uint64_t *const out);
+    void __dachs_heap_profile_init__();
+    void *__dachs_profiled_malloc__(std::size_t const size, char const* const site);
+    void __dachs_function_profile_init__();
+    std::uint64_t __dachs_function_profile_register__(char const* const* const names, std::uint64_t const size);
+    void __dachs_function_enter__(std::uint64_t const slot);
+    void __dachs_function_exit__();
+    void __dachs_pgo_register__(char const* const file, char const* const name, std::uint64_t const checksum, std::uint64_t const size, std::uint64_t *const counters);
+    void *__dachs_malloc__(std::size_t const size);
+    void *__dachs_malloc_small__(std::size_t const size);
+    void *__dachs_realloc__(void *const ptr, std::size_t const size);
+    void __dachs_free__(void *const ptr);
+    std::uint64_t __dachs_arena_new__(std::uint64_t const chunk_size);
+    std::uint64_t __dachs_arena_switch__(std::uint64_t const arena);
+    void __dachs_arena_release__(std::uint64_t const arena);
+    std::uint64_t __dachs_arena_allocated__(std::uint64_t const arena);
 }
 
 #endif    // DACHS_RUNTIME_RUNTIME_HPP_INCLUDED
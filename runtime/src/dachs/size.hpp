@@ -0,0 +1,58 @@
+#if !defined DACHS_RUNTIME_SIZE_HPP_INCLUDED
+#define      DACHS_RUNTIME_SIZE_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstdlib>
+#include <cerrno>
+#include <limits>
+
+namespace dachs {
+namespace runtime {
+
+// Note:
+// Parse a size with an optional suffix 'K', 'M' or 'G' (e.g. "64M").
+// It is shared by the runtime (DACHS_GC_* environment variables) and the
+// compiler (--gc-* options), so it is defined only here.
+inline bool parse_size(char const* const s, std::uint64_t &out) noexcept
+{
+    if (!s || *s < '0' || '9' < *s) {
+        return false;
+    }
+
+    char *end;
+    errno = 0;
+    auto const n = std::strtoull(s, &end, 10);
+    if (errno == ERANGE) {
+        return false;
+    }
+
+    std::uint64_t unit = 1u;
+    switch (*end) {
+    case 'k': case 'K':
+        unit = 1ull << 10;
+        ++end;
+        break;
+    case 'm': case 'M':
+        unit = 1ull << 20;
+        ++end;
+        break;
+    case 'g': case 'G':
+        unit = 1ull << 30;
+        ++end;
+        break;
+    default:
+        break;
+    }
+
+    if (*end != '\0' || n > std::numeric_limits<std::uint64_t>::max() / unit) {
+        return false;
+    }
+
+    out = n * unit;
+    return true;
+}
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_SIZE_HPP_INCLUDED
@@ -0,0 +1,257 @@
+#include <cstdlib>
+#include <thread>
+#include <new>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <gc.h>
+
+#include "dachs/task.hpp"
+
+namespace dachs {
+namespace runtime {
+namespace detail {
+
+// Note:
+// Which scheduler and which queue the current thread works for.
+// They are not set in threads other than workers (e.g. the main thread).
+thread_local scheduler *current_scheduler = nullptr;
+thread_local std::size_t current_worker = 0u;
+
+struct worker_arg {
+    scheduler *sched;
+    std::size_t index;
+};
+
+} // namespace detail
+
+scheduler::scheduler(std::size_t const num_workers)
+{
+    auto const n = num_workers == 0u ? 1u : num_workers;
+    queues.reserve(n);
+    for (auto i = 0u; i < n; ++i) {
+        queues.emplace_back(new work_queue);
+    }
+
+    // Note:
+    // Workers which have already started must be stopped before the exception
+    // leaves the constructor because they refer to this scheduler.
+    try {
+        for (auto i = 0u; i < n; ++i) {
+            auto *const arg = new detail::worker_arg{this, i};
+            num_running_workers.fetch_add(1u);
+            pthread_t thread;
+            if (GC_pthread_create(&thread, nullptr, &scheduler::worker_entry, arg) != 0) {
+                delete arg;
+                num_running_workers.fetch_sub(1u);
+                throw std::runtime_error{"failed to create a worker thread"};
+            }
+            GC_pthread_detach(thread);
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+scheduler::~scheduler()
+{
+    stop();
+}
+
+void scheduler::stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{sleep_mutex};
+        stopping.store(true);
+        wake_up.notify_all();
+    }
+
+    while (num_running_workers.load() > 0u) {
+        std::this_thread::yield();
+    }
+}
+
+void *scheduler::worker_entry(void *const arg)
+{
+    auto const a = *static_cast<detail::worker_arg *>(arg);
+    delete static_cast<detail::worker_arg *>(arg);
+    a.sched->run_worker(a.index);
+    return nullptr;
+}
+
+void scheduler::push(task *const t)
+{
+    auto const index
+        = detail::current_scheduler == this
+            ? detail::current_worker
+            : next_queue.fetch_add(1u, std::memory_order_relaxed) % queues.size();
+
+    // Note:
+    // num_pending must be increased before checking num_sleeping.  A worker
+    // going to sleep increases num_sleeping and then checks num_pending.
+    // So at least one of them notices the other.
+    num_pending.fetch_add(1u);
+
+    {
+        auto &q = *queues[index];
+        std::lock_guard<std::mutex> lock{q.mutex};
+        q.tasks.push_back(t);
+    }
+
+    if (num_sleeping.load() > 0u) {
+        std::lock_guard<std::mutex> lock{sleep_mutex};
+        wake_up.notify_one();
+    }
+}
+
+task *scheduler::pop(std::size_t const index) noexcept
+{
+    auto &q = *queues[index];
+    std::lock_guard<std::mutex> lock{q.mutex};
+    if (q.tasks.empty()) {
+        return nullptr;
+    }
+    auto *const t = q.tasks.back();
+    q.tasks.pop_back();
+    return t;
+}
+
+task *scheduler::steal(std::size_t const thief) noexcept
+{
+    auto const n = queues.size();
+    for (auto i = 1u; i <= n; ++i) {
+        auto &q = *queues[(thief + i) % n];
+        std::unique_lock<std::mutex> lock{q.mutex, std::try_to_lock};
+        if (!lock || q.tasks.empty()) {
+            continue;
+        }
+        auto *const t = q.tasks.front();
+        q.tasks.pop_front();
+        return t;
+    }
+    return nullptr;
+}
+
+task *scheduler::find_task() noexcept
+{
+    if (num_pending.load(std::memory_order_relaxed) == 0u) {
+        return nullptr;
+    }
+
+    task *t = nullptr;
+    if (detail::current_scheduler == this) {
+        t = pop(detail::current_worker);
+        if (!t) {
+            t = steal(detail::current_worker);
+        }
+    } else {
+        t = steal(next_queue.load(std::memory_order_relaxed));
+    }
+
+    if (t) {
+        num_pending.fetch_sub(1u);
+    }
+    return t;
+}
+
+bool scheduler::run_one() noexcept
+{
+    auto *const t = find_task();
+    if (!t) {
+        return false;
+    }
+
+    t->func(t->env);
+    t->done.store(true, std::memory_order_release);
+    return true;
+}
+
+void scheduler::run_worker(std::size_t const index)
+{
+    detail::current_scheduler = this;
+    detail::current_worker = index;
+
+    while (!stopping.load()) {
+        // Note:
+        // Spin for a while before sleeping because tasks are usually spawned in bulk.
+        for (auto spin = 0u; spin < 64u && !stopping.load(std::memory_order_relaxed); ++spin) {
+            while (run_one()) {
+                spin = 0u;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock{sleep_mutex};
+        num_sleeping.fetch_add(1u);
+        wake_up.wait(lock, [this]{ return num_pending.load() > 0u || stopping.load(); });
+        num_sleeping.fetch_sub(1u);
+    }
+
+    // Note:
+    // This must be the last access to the scheduler.  It may be destroyed soon after.
+    num_running_workers.fetch_sub(1u);
+}
+
+task *scheduler::spawn(task_func_type const func, void *const env)
+{
+    auto *const mem = GC_MALLOC_UNCOLLECTABLE(sizeof(task));
+    if (!mem) {
+        throw std::bad_alloc{};
+    }
+
+    auto *const t = new (mem) task;
+    t->func = func;
+    t->env = env;
+    t->done.store(false, std::memory_order_relaxed);
+
+    push(t);
+    return t;
+}
+
+void scheduler::join(task *const t)
+{
+    while (!t->done.load(std::memory_order_acquire)) {
+        if (!run_one()) {
+            std::this_thread::yield();
+        }
+    }
+
+    t->~task();
+    GC_FREE(t);
+}
+
+std::size_t default_num_workers() noexcept
+{
+    if (auto const *const env = std::getenv("DACHS_NUM_THREADS")) {
+        auto const n = std::strtoul(env, nullptr, 10);
+        if (n > 0u) {
+            return n;
+        }
+    }
+
+    auto const n = std::thread::hardware_concurrency();
+    return n == 0u ? 1u : n;
+}
+
+namespace detail {
+
+std::atomic<scheduler *> created_global_scheduler{nullptr};
+
+} // namespace detail
+
+scheduler &global_scheduler()
+{
+    static auto *const s = new scheduler{default_num_workers()};
+    detail::created_global_scheduler.store(s, std::memory_order_release);
+    return *s;
+}
+
+bool run_pending_task() noexcept
+{
+    auto *const s = detail::created_global_scheduler.load(std::memory_order_acquire);
+    return s && s->run_one();
+}
+
+} // namespace runtime
+} // namespace dachs
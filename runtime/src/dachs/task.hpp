@@ -0,0 +1,100 @@
+#if !defined DACHS_RUNTIME_TASK_HPP_INCLUDED
+#define      DACHS_RUNTIME_TASK_HPP_INCLUDED
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+
+namespace dachs {
+namespace runtime {
+
+using task_func_type = void (*)(void *);
+
+// Note:
+// 'env' is the capture struct of a lambda.  A task is allocated as an
+// uncollectable GC object so that 'env' is kept alive while the task is queued.
+struct task {
+    task_func_type func;
+    void *env;
+    std::atomic<bool> done;
+};
+
+// Note:
+// Work-stealing scheduler.  Each worker owns a deque.  The owner pushes and
+// pops tasks at the back (LIFO) and other threads steal them from the front (FIFO).
+// Worker threads are created via GC_pthread_create() so that GC can scan their stacks.
+class scheduler {
+    struct work_queue {
+        std::mutex mutex;
+        std::deque<task *> tasks;
+    };
+
+    std::vector<std::unique_ptr<work_queue>> queues;
+    std::atomic<std::size_t> num_pending{0u};
+    std::atomic<std::size_t> num_sleeping{0u};
+    std::atomic<std::size_t> next_queue{0u};
+    std::atomic<std::size_t> num_running_workers{0u};
+    std::atomic<bool> stopping{false};
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+
+    void push(task *const t);
+    task *pop(std::size_t const index) noexcept;
+    task *steal(std::size_t const thief) noexcept;
+    task *find_task() noexcept;
+    void run_worker(std::size_t const index);
+    void stop() noexcept;
+
+    static void *worker_entry(void *const arg);
+
+public:
+
+    explicit scheduler(std::size_t const num_workers);
+
+    // Note:
+    // Wait for all workers to exit.  Pending tasks are not run.
+    ~scheduler();
+
+    scheduler(scheduler const&) = delete;
+    scheduler &operator=(scheduler const&) = delete;
+
+    task *spawn(task_func_type const func, void *const env);
+
+    // Note:
+    // The joining thread runs other pending tasks while waiting.  It prevents
+    // a deadlock when a task joins its child tasks.  The task is freed after join.
+    void join(task *const t);
+
+    // Note:
+    // Run one pending task if exists.  Return false when no task is found.
+    bool run_one() noexcept;
+
+    std::size_t num_workers() const noexcept
+    {
+        return queues.size();
+    }
+};
+
+// Note:
+// The number of workers is taken from DACHS_NUM_THREADS environment variable.
+// Default is the number of hardware threads.
+std::size_t default_num_workers() noexcept;
+
+// Note:
+// Created at the first use.  It is never destroyed because workers may still
+// refer to it at exit.
+scheduler &global_scheduler();
+
+// Note:
+// Run one pending task of the global scheduler if it has been created.
+// Used while waiting in blocking operations.
+bool run_pending_task() noexcept;
+
+} // namespace runtime
+} // namespace dachs
+
+#endif    // DACHS_RUNTIME_TASK_HPP_INCLUDED
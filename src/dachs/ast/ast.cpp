@@ -109,7 +109,7 @@ std::string primary_literal::to_string() const noexcept
 
     } v;
 
-    return "PRIMARY_LITERAL: " + boost::apply_visitor(v, value);
+    return "PRIMARY_LITERAL: " + boost::apply_visitor(v, value) + (suffix.empty() ? "" : " (" + suffix + ')');
 }
 
 bool function_definition::is_template() noexcept
@@ -252,11 +252,21 @@ struct primary_literal final : public expression {
                   , unsigned int
                 > value;
 
+    // Note:
+    // Name of fixed-width type specified by a literal suffix (e.g. "i8" of '42i8').
+    // Empty when the literal has no suffix.
+    std::string suffix;
+
     template<class T>
     explicit primary_literal(T && v) noexcept
         : value{std::forward<T>(v)}
     {}
 
+    template<class T>
+    primary_literal(T && v, std::string const& s) noexcept
+        : value{std::forward<T>(v)}, suffix(s)
+    {}
+
     std::string to_string() const noexcept override;
 };
 
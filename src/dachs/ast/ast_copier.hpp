@@ -89,7 +89,7 @@ public:
 
     auto copy(node::primary_literal const& pl) const
     {
-        return copy_node(pl, pl->value);
+        return copy_node(pl, pl->value, pl->suffix);
     }
 
     auto copy(node::array_literal const& al) const
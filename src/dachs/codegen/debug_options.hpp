@@ -0,0 +1,21 @@
+#if !defined DACHS_CODEGEN_DEBUG_OPTIONS_HPP_INCLUDED
+#define      DACHS_CODEGEN_DEBUG_OPTIONS_HPP_INCLUDED
+
+namespace dachs {
+namespace codegen {
+
+// Note:
+// When 'debug_info' is true, DWARF compile units, subprograms and line locations
+// are emitted so that debuggers and profilers can map machine code to Dachs
+// source lines.  When 'frame_pointer' is true, frame pointers are kept in all
+// functions so that stack unwinding by profilers (e.g. perf record -g) works
+// even with --release.
+struct debug_options {
+    bool debug_info = false;
+    bool frame_pointer = false;
+};
+
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_DEBUG_OPTIONS_HPP_INCLUDED
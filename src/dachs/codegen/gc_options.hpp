@@ -0,0 +1,25 @@
+#if !defined DACHS_CODEGEN_GC_OPTIONS_HPP_INCLUDED
+#define      DACHS_CODEGEN_GC_OPTIONS_HPP_INCLUDED
+
+#include <cstdint>
+
+namespace dachs {
+namespace codegen {
+
+// Note:
+// GC settings embedded in the entry point of an executable.  0 (or false) means
+// the default of Boehm GC.  DACHS_GC_* environment variables override them at run time.
+// When 'heap_profile' is true, allocations are counted per source location and
+// reported at exit.
+struct gc_options {
+    std::uint64_t markers = 0u;
+    bool incremental = false;
+    std::uint64_t initial_heap_size = 0u;
+    std::uint64_t free_space_divisor = 0u;
+    bool heap_profile = false;
+};
+
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_GC_OPTIONS_HPP_INCLUDED
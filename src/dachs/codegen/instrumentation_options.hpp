@@ -0,0 +1,18 @@
+#if !defined DACHS_CODEGEN_INSTRUMENTATION_OPTIONS_HPP_INCLUDED
+#define      DACHS_CODEGEN_INSTRUMENTATION_OPTIONS_HPP_INCLUDED
+
+namespace dachs {
+namespace codegen {
+
+// Note:
+// Code inserted into functions to measure the program itself.  When
+// 'profile_functions' is true, calls and cycles are counted per function and
+// reported at exit with the call graph.
+struct instrumentation_options {
+    bool profile_functions = false;
+};
+
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_INSTRUMENTATION_OPTIONS_HPP_INCLUDED
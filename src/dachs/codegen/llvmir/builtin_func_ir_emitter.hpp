@@ -16,6 +16,7 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/InlineAsm.h>
 
 #include "dachs/semantics/type.hpp"
 #include "dachs/semantics/scope.hpp"
@@ -41,6 +42,8 @@ class builtin_function_emitter {
     std::unordered_map<std::string, func_table_type> print_func_tables;
     llvm::Function *gen_symbol_func = nullptr;
     func_table_type address_of_func_table;
+    llvm::Function *monotonic_ns_func = nullptr;
+    func_table_type black_box_func_table;
     llvm::Function *getchar_func = nullptr;
     std::array<llvm::Function *, 2> fatal_funcs = {{nullptr, nullptr}};
     func_table_type is_null_func_table;
@@ -49,6 +52,62 @@ class builtin_function_emitter {
     llvm::Function *enable_gc_func = nullptr;
     llvm::Function *disable_gc_func = nullptr;
     llvm::Function *gc_disabled_func = nullptr;
+    llvm::Function *gc_collect_func = nullptr;
+    llvm::Function *gc_enable_incremental_func = nullptr;
+    llvm::Function *gc_set_free_space_divisor_func = nullptr;
+    llvm::Function *gc_expand_heap_func = nullptr;
+    llvm::Function *gc_stats_func = nullptr;
+    llvm::Function *int_length_func = nullptr;
+    llvm::Function *uint_length_func = nullptr;
+    llvm::Function *format_int_func = nullptr;
+    llvm::Function *format_uint_func = nullptr;
+    llvm::Function *format_float_func = nullptr;
+    llvm::Function *parse_int_func = nullptr;
+    llvm::Function *parse_float_func = nullptr;
+    llvm::Function *read_line_func = nullptr;
+    llvm::Function *read_token_func = nullptr;
+    llvm::Function *read_all_func = nullptr;
+    llvm::Function *read_char_func = nullptr;
+    llvm::Function *stdin_eof_func = nullptr;
+    llvm::Function *file_open_func = nullptr;
+    llvm::Function *file_close_func = nullptr;
+    llvm::Function *file_write_func = nullptr;
+    llvm::Function *file_flush_func = nullptr;
+    llvm::Function *file_read_func = nullptr;
+    llvm::Function *file_read_all_func = nullptr;
+    llvm::Function *file_size_func = nullptr;
+    llvm::Function *mmap_read_func = nullptr;
+    llvm::Function *munmap_func = nullptr;
+    llvm::Function *next_line_func = nullptr;
+    llvm::Function *runtime_task_spawn_func = nullptr;
+    func_table_type task_spawn_func_table;
+    llvm::Function *task_join_func = nullptr;
+    llvm::Function *num_workers_func = nullptr;
+    llvm::Function *ring_new_func = nullptr;
+    llvm::Function *ring_capacity_func = nullptr;
+    llvm::Function *ring_size_func = nullptr;
+    llvm::Function *ring_try_claim_push_func = nullptr;
+    llvm::Function *ring_claim_push_func = nullptr;
+    llvm::Function *ring_publish_push_func = nullptr;
+    llvm::Function *ring_try_claim_pop_func = nullptr;
+    llvm::Function *ring_claim_pop_func = nullptr;
+    llvm::Function *ring_release_pop_func = nullptr;
+    llvm::Function *spsc_new_func = nullptr;
+    llvm::Function *spsc_empty_func = nullptr;
+    llvm::Function *runtime_spsc_push_func = nullptr;
+    llvm::Function *runtime_spsc_try_pop_func = nullptr;
+    llvm::Function *runtime_spsc_pop_func = nullptr;
+    func_table_type spsc_push_func_table;
+    func_table_type spsc_try_pop_func_table;
+    func_table_type spsc_pop_func_table;
+    llvm::Function *arena_new_func = nullptr;
+    llvm::Function *arena_switch_func = nullptr;
+    llvm::Function *arena_release_func = nullptr;
+    llvm::Function *arena_allocated_func = nullptr;
+    llvm::Function *function_profile_init_func = nullptr;
+    llvm::Function *function_profile_register_func = nullptr;
+    llvm::Function *function_enter_func = nullptr;
+    llvm::Function *function_exit_func = nullptr;
 
     template<class String>
     llvm::Function *create_func_prototype(String const& name, llvm::Type *const ret_ty, std::initializer_list<llvm::Type *> const& arg_tys)
@@ -213,6 +272,113 @@ public:
         return llvm::Intrinsic::getDeclaration(&module, llvm::Intrinsic::readcyclecounter);
     }
 
+    llvm::Function *emit_monotonic_ns_func()
+    {
+        return create_cached_func_prototype(
+                monotonic_ns_func,
+                "__dachs_monotonic_ns__",
+                c.builder.getInt64Ty(),
+                {}
+            );
+    }
+
+    // Note:
+    // The value goes through a volatile store and load.  LLVM must keep both of
+    // them, so the computation of the value can't be deleted or hoisted out of
+    // the measured loop even if the result is unused.
+    llvm::Function *emit_black_box_func(type::type const& arg_type)
+    {
+        std::string type_str = arg_type.to_string();
+
+        auto const func_itr = black_box_func_table.find(type_str);
+        if (func_itr != std::end(black_box_func_table)) {
+            return func_itr->second;
+        }
+
+        auto *const arg_ty = type_emitter.emit(arg_type);
+        auto *const prototype = create_func_prototype(
+                "dachs.black_box." + type_str,
+                arg_ty,
+                {arg_ty}
+            );
+
+        prototype->addFnAttr(llvm::Attribute::AlwaysInline);
+
+        auto const arg_value = prototype->arg_begin();
+        arg_value->setName("value");
+
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+        auto *const body = llvm::BasicBlock::Create(c.llvm_context, "entry", prototype);
+        c.builder.SetInsertPoint(body);
+        auto *const slot = c.builder.CreateAlloca(arg_ty, nullptr, "black_box");
+        c.builder.CreateStore(arg_value, slot);
+
+        // Note:
+        // Empty inline assembly which takes the address of the slot and clobbers memory.
+        // Optimizer must assume it reads and rewrites the value.  So the value must be
+        // computed before it and the returned value is unknown.  As the assembly has
+        // side effects, it is neither hoisted out of loops nor removed.
+        auto *const barrier = llvm::InlineAsm::get(
+                llvm::FunctionType::get(c.builder.getVoidTy(), {slot->getType()}, false),
+                "",
+                "r,~{memory}",
+                true /*has side effects*/
+            );
+        c.builder.CreateCall(barrier, slot);
+
+        c.builder.CreateRet(c.builder.CreateLoad(slot));
+        c.builder.SetInsertPoint(saved_insert_point);
+
+        black_box_func_table.emplace(std::move(type_str), prototype);
+
+        return prototype;
+    }
+
+    // Note:
+    // Runtime functions called by the instrumentation of --profile-functions
+    llvm::Function *emit_function_profile_init_func()
+    {
+        return create_cached_func_prototype(
+                function_profile_init_func,
+                "__dachs_function_profile_init__",
+                c.builder.getVoidTy(),
+                {}
+            );
+    }
+
+    llvm::Function *emit_function_profile_register_func()
+    {
+        return create_cached_func_prototype(
+                function_profile_register_func,
+                "__dachs_function_profile_register__",
+                c.builder.getInt64Ty(),
+                {
+                    c.builder.getInt8PtrTy()->getPointerTo(),
+                    c.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *emit_function_enter_func()
+    {
+        return create_cached_func_prototype(
+                function_enter_func,
+                "__dachs_function_enter__",
+                c.builder.getVoidTy(),
+                {c.builder.getInt64Ty()}
+            );
+    }
+
+    llvm::Function *emit_function_exit_func()
+    {
+        return create_cached_func_prototype(
+                function_exit_func,
+                "__dachs_function_exit__",
+                c.builder.getVoidTy(),
+                {}
+            );
+    }
+
     llvm::Function *emit_getchar_func()
     {
         return create_cached_func_prototype(
@@ -424,6 +590,498 @@ public:
             );
     }
 
+    llvm::Function *emit_length_func(llvm::Function *&func, char const* const name)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                c.builder.getInt64Ty(),
+                {
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *emit_format_integer_func(llvm::Function *&func, char const* const name)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                c.builder.getInt64Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *emit_format_float_func()
+    {
+        return create_cached_func_prototype(
+                format_float_func,
+                "__dachs_format_float__",
+                c.builder.getInt64Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getDoubleTy()
+                }
+            );
+    }
+
+    llvm::Function *emit_parse_int_func()
+    {
+        return create_cached_func_prototype(
+                parse_int_func,
+                "__dachs_parse_int__",
+                c.builder.getInt1Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty()->getPointerTo()
+                }
+            );
+    }
+
+    llvm::Function *emit_parse_float_func()
+    {
+        return create_cached_func_prototype(
+                parse_float_func,
+                "__dachs_parse_float__",
+                c.builder.getInt1Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty(),
+                    c.builder.getDoubleTy()->getPointerTo()
+                }
+            );
+    }
+
+    llvm::Function *emit_read_string_func(llvm::Function *&func, char const* const name)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                c.builder.getInt8PtrTy(),
+                {c.builder.getInt64Ty()->getPointerTo()}
+            );
+    }
+
+    llvm::Function *emit_read_char_func()
+    {
+        return create_cached_func_prototype(
+                read_char_func,
+                "__dachs_read_char__",
+                c.builder.getInt64Ty(),
+                {}
+            );
+    }
+
+    llvm::Function *emit_stdin_eof_func()
+    {
+        return create_cached_func_prototype(
+                stdin_eof_func,
+                "__dachs_stdin_eof__",
+                c.builder.getInt1Ty(),
+                {}
+            );
+    }
+
+    llvm::Function *emit_file_open_func()
+    {
+        return create_cached_func_prototype(
+                file_open_func,
+                "__dachs_file_open__",
+                c.builder.getInt64Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt8PtrTy()
+                }
+            );
+    }
+
+    // Note:
+    // Functions which receive only a file handle
+    llvm::Function *emit_file_handle_func(llvm::Function *&func, char const* const name, llvm::Type *const ret_ty)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                ret_ty,
+                {c.builder.getInt64Ty()}
+            );
+    }
+
+    // Note:
+    // Functions which receive a file handle and a buffer
+    llvm::Function *emit_file_buffer_func(llvm::Function *&func, char const* const name, llvm::Type *const ret_ty)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                ret_ty,
+                {
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *emit_file_read_all_func()
+    {
+        return create_cached_func_prototype(
+                file_read_all_func,
+                "__dachs_file_read_all__",
+                c.builder.getInt8PtrTy(),
+                {
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty()->getPointerTo()
+                }
+            );
+    }
+
+    llvm::Function *emit_mmap_read_func()
+    {
+        return create_cached_func_prototype(
+                mmap_read_func,
+                "__dachs_mmap_read__",
+                c.builder.getInt8PtrTy(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty()->getPointerTo()
+                }
+            );
+    }
+
+    llvm::Function *emit_munmap_func()
+    {
+        return create_cached_func_prototype(
+                munmap_func,
+                "__dachs_munmap__",
+                c.builder.getInt1Ty(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *emit_next_line_func()
+    {
+        return create_cached_func_prototype(
+                next_line_func,
+                "__dachs_next_line__",
+                c.builder.getInt8PtrTy(),
+                {
+                    c.builder.getInt8PtrTy(),
+                    c.builder.getInt64Ty(),
+                    c.builder.getInt64Ty()->getPointerTo(),
+                    c.builder.getInt64Ty()->getPointerTo()
+                }
+            );
+    }
+
+    // Note:
+    // A task runs a lambda which takes no parameter.  The lambda function receives its
+    // capture struct as the first argument.  So a task entry function which receives
+    // the capture struct as 'i8*' and forwards it to the lambda function is generated
+    // and passed to runtime with the capture struct.
+    llvm::Function *emit_task_spawn_func(type::type const& arg_type)
+    {
+        auto const generic = type::get<type::generic_func_type>(arg_type);
+        if (!generic || !(*generic)->ref || (*generic)->ref->expired()) {
+            throw code_generation_error{
+                "LLVM IR generator", "\n  Failed to emit builtin function: "
+                "Argument of __builtin_task_spawn(" + arg_type.to_string() + ") must be a lambda"
+            };
+        }
+
+        auto const lambda_scope = (*generic)->ref->lock();
+        auto const lambda_name = lambda_scope->to_string();
+
+        {
+            auto const itr = task_spawn_func_table.find(lambda_name);
+            if (itr != std::end(task_spawn_func_table)) {
+                return itr->second;
+            }
+        }
+
+        auto *const lambda_func = module.getFunction(lambda_name);
+        if (!lambda_func || lambda_func->getFunctionType()->getNumParams() != 1u) {
+            throw code_generation_error{
+                "LLVM IR generator", "\n  Failed to emit builtin function: "
+                "Lambda passed to __builtin_task_spawn() must take no parameter: " + lambda_name
+            };
+        }
+
+        auto *const i8ptr_ty = c.builder.getInt8PtrTy();
+
+        auto *const entry_func = llvm::Function::Create(
+                llvm::FunctionType::get(c.builder.getVoidTy(), {i8ptr_ty}, false),
+                llvm::Function::InternalLinkage,
+                lambda_name + ".task",
+                &module
+            );
+        entry_func->addFnAttr(llvm::Attribute::NoUnwind);
+
+        auto *const spawn_runtime_func = create_cached_func_prototype(
+                runtime_task_spawn_func,
+                "__dachs_task_spawn__",
+                c.builder.getInt64Ty(),
+                {entry_func->getType(), i8ptr_ty}
+            );
+
+        auto *const prototype = create_func_prototype(
+                "__builtin_task_spawn",
+                c.builder.getInt64Ty(),
+                {type_emitter.emit(arg_type)}
+            );
+        prototype->addFnAttr(llvm::Attribute::InlineHint);
+
+        auto const lambda_value = prototype->arg_begin();
+        lambda_value->setName("lambda");
+
+        auto const env_value = entry_func->arg_begin();
+        env_value->setName("env");
+
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+
+        c.builder.SetInsertPoint(llvm::BasicBlock::Create(c.llvm_context, "entry", entry_func));
+        c.builder.CreateCall(
+                lambda_func,
+                c.builder.CreateBitCast(env_value, lambda_func->getFunctionType()->getParamType(0u))
+            );
+        c.builder.CreateRetVoid();
+
+        c.builder.SetInsertPoint(llvm::BasicBlock::Create(c.llvm_context, "entry", prototype));
+        c.builder.CreateRet(
+                c.builder.CreateCall2(
+                    spawn_runtime_func,
+                    entry_func,
+                    c.builder.CreateBitCast(lambda_value, i8ptr_ty)
+                )
+            );
+
+        c.builder.SetInsertPoint(saved_insert_point);
+
+        task_spawn_func_table.emplace(lambda_name, prototype);
+
+        return prototype;
+    }
+
+    // Note:
+    // Wrap a runtime function returning void with a function returning unit
+    llvm::Function *emit_unit_wrapped_func(
+            llvm::Function *&func,
+            char const* const name,
+            char const* const runtime_name,
+            std::initializer_list<llvm::Type *> const& arg_tys)
+    {
+        if (func) {
+            return func;
+        }
+
+        auto *const inner_prototype = create_func_prototype(
+                runtime_name,
+                c.builder.getVoidTy(),
+                arg_tys
+            );
+
+        func = create_func_prototype(
+                name,
+                llvm::StructType::get(c.llvm_context, {})->getPointerTo(),
+                arg_tys
+            );
+        func->addFnAttr(llvm::Attribute::InlineHint);
+
+        std::vector<llvm::Value *> args;
+        for (auto itr = func->arg_begin(); itr != func->arg_end(); ++itr) {
+            args.push_back(itr);
+        }
+
+        auto *const body = llvm::BasicBlock::Create(c.llvm_context, "entry", func);
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+
+        c.builder.SetInsertPoint(body);
+        c.builder.CreateCall(inner_prototype, args);
+        c.builder.CreateRet(inst_emitter.emit_unit_constant());
+
+        c.builder.SetInsertPoint(saved_insert_point);
+        return func;
+    }
+
+    llvm::Function *emit_task_join_func()
+    {
+        return emit_unit_wrapped_func(
+                task_join_func,
+                "__builtin_task_join",
+                "__dachs_task_join__",
+                {c.builder.getInt64Ty()}
+            );
+    }
+
+    llvm::Function *emit_num_workers_func()
+    {
+        return create_cached_func_prototype(
+                num_workers_func,
+                "__dachs_num_workers__",
+                c.builder.getInt64Ty(),
+                {}
+            );
+    }
+
+    // Note:
+    // Functions which receive a ring handle and return a position, a ticket or a size
+    llvm::Function *emit_ring_func(llvm::Function *&func, char const* const name)
+    {
+        return create_cached_func_prototype(
+                func,
+                name,
+                c.builder.getInt64Ty(),
+                {c.builder.getInt64Ty()}
+            );
+    }
+
+    // Note:
+    // Values in SPSC queue are boxed in Dachs.  Below functions convert typed
+    // box pointers from/to 'i8*' for runtime.
+    llvm::Function *emit_spsc_push_func(type::type const& box_type)
+    {
+        auto const type_str = box_type.to_string();
+        {
+            auto const itr = spsc_push_func_table.find(type_str);
+            if (itr != std::end(spsc_push_func_table)) {
+                return itr->second;
+            }
+        }
+
+        auto *const runtime_func = create_cached_func_prototype(
+                runtime_spsc_push_func,
+                "__dachs_spsc_push__",
+                c.builder.getVoidTy(),
+                {c.builder.getInt64Ty(), c.builder.getInt8PtrTy()}
+            );
+
+        auto *const prototype = create_func_prototype(
+                "__builtin_spsc_push",
+                llvm::StructType::get(c.llvm_context, {})->getPointerTo(),
+                {c.builder.getInt64Ty(), type_emitter.emit(box_type)}
+            );
+        prototype->addFnAttr(llvm::Attribute::InlineHint);
+
+        auto const handle_value = prototype->arg_begin();
+        handle_value->setName("queue");
+        auto const box_value = std::next(handle_value);
+        box_value->setName("box");
+
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+        c.builder.SetInsertPoint(llvm::BasicBlock::Create(c.llvm_context, "entry", prototype));
+        c.builder.CreateCall2(
+                runtime_func,
+                handle_value,
+                c.builder.CreateBitCast(box_value, c.builder.getInt8PtrTy())
+            );
+        c.builder.CreateRet(inst_emitter.emit_unit_constant());
+        c.builder.SetInsertPoint(saved_insert_point);
+
+        spsc_push_func_table.emplace(type_str, prototype);
+        return prototype;
+    }
+
+    llvm::Function *emit_spsc_try_pop_func(type::type const& out_type)
+    {
+        auto const type_str = out_type.to_string();
+        {
+            auto const itr = spsc_try_pop_func_table.find(type_str);
+            if (itr != std::end(spsc_try_pop_func_table)) {
+                return itr->second;
+            }
+        }
+
+        auto *const i8ptr_ty = c.builder.getInt8PtrTy();
+        auto *const runtime_func = create_cached_func_prototype(
+                runtime_spsc_try_pop_func,
+                "__dachs_spsc_try_pop__",
+                c.builder.getInt1Ty(),
+                {c.builder.getInt64Ty(), i8ptr_ty->getPointerTo()}
+            );
+
+        auto *const prototype = create_func_prototype(
+                "__builtin_spsc_try_pop",
+                c.builder.getInt1Ty(),
+                {c.builder.getInt64Ty(), type_emitter.emit(out_type)}
+            );
+        prototype->addFnAttr(llvm::Attribute::InlineHint);
+
+        auto const handle_value = prototype->arg_begin();
+        handle_value->setName("queue");
+        auto const out_value = std::next(handle_value);
+        out_value->setName("out");
+
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+        c.builder.SetInsertPoint(llvm::BasicBlock::Create(c.llvm_context, "entry", prototype));
+        c.builder.CreateRet(
+                c.builder.CreateCall2(
+                    runtime_func,
+                    handle_value,
+                    c.builder.CreateBitCast(out_value, i8ptr_ty->getPointerTo())
+                )
+            );
+        c.builder.SetInsertPoint(saved_insert_point);
+
+        spsc_try_pop_func_table.emplace(type_str, prototype);
+        return prototype;
+    }
+
+    llvm::Function *emit_spsc_pop_func(type::type const& out_type)
+    {
+        auto const type_str = out_type.to_string();
+        {
+            auto const itr = spsc_pop_func_table.find(type_str);
+            if (itr != std::end(spsc_pop_func_table)) {
+                return itr->second;
+            }
+        }
+
+        auto *const runtime_func = create_cached_func_prototype(
+                runtime_spsc_pop_func,
+                "__dachs_spsc_pop__",
+                c.builder.getInt8PtrTy(),
+                {c.builder.getInt64Ty()}
+            );
+
+        auto *const out_ty = type_emitter.emit(out_type);
+        auto *const prototype = create_func_prototype(
+                "__builtin_spsc_pop",
+                llvm::StructType::get(c.llvm_context, {})->getPointerTo(),
+                {c.builder.getInt64Ty(), out_ty}
+            );
+        prototype->addFnAttr(llvm::Attribute::InlineHint);
+
+        auto const handle_value = prototype->arg_begin();
+        handle_value->setName("queue");
+        auto const out_value = std::next(handle_value);
+        out_value->setName("out");
+
+        auto *const saved_insert_point = c.builder.GetInsertBlock();
+        c.builder.SetInsertPoint(llvm::BasicBlock::Create(c.llvm_context, "entry", prototype));
+        c.builder.CreateStore(
+                c.builder.CreateBitCast(
+                    c.builder.CreateCall(runtime_func, handle_value),
+                    out_ty->getPointerElementType()
+                ),
+                out_value
+            );
+        c.builder.CreateRet(inst_emitter.emit_unit_constant());
+        c.builder.SetInsertPoint(saved_insert_point);
+
+        spsc_pop_func_table.emplace(type_str, prototype);
+        return prototype;
+    }
+
     llvm::Function *emit(std::string const& name, std::vector<type::type> const& arg_types)
     {
         if (name == "print" || name == "println") {
@@ -435,6 +1093,11 @@ public:
             }
         } else if (name == "__builtin_read_cycle_counter") {
             return emit_read_cycle_counter_func();
+        } else if (name == "__builtin_monotonic_ns") {
+            assert(arg_types.empty());
+            return emit_monotonic_ns_func();
+        } else if (name == "__builtin_black_box") {
+            return emit_black_box_func(arg_types[0]);
         } else if (name == "__builtin_address_of") {
             return emit_address_of_func(arg_types[0]);
         } else if (name == "__builtin_getchar") {
@@ -460,6 +1123,132 @@ public:
             return emit_disable_gc_func();
         } else if (name == "__builtin_gc_disabled?") {
             return emit_gc_disabled_func();
+        } else if (name == "__builtin_gc_collect") {
+            return emit_unit_wrapped_func(gc_collect_func, "__builtin_gc_collect", "GC_gcollect", {});
+        } else if (name == "__builtin_gc_enable_incremental") {
+            return emit_unit_wrapped_func(gc_enable_incremental_func, "__builtin_gc_enable_incremental", "GC_enable_incremental", {});
+        } else if (name == "__builtin_gc_set_free_space_divisor") {
+            return emit_unit_wrapped_func(
+                    gc_set_free_space_divisor_func,
+                    "__builtin_gc_set_free_space_divisor",
+                    "GC_set_free_space_divisor",
+                    {c.builder.getInt64Ty()}
+                );
+        } else if (name == "__builtin_gc_stats") {
+            return emit_unit_wrapped_func(
+                    gc_stats_func,
+                    "__builtin_gc_stats",
+                    "__dachs_gc_stats__",
+                    {c.builder.getInt64Ty()->getPointerTo()}
+                );
+        } else if (name == "__builtin_gc_expand_heap") {
+            return create_cached_func_prototype(
+                    gc_expand_heap_func,
+                    "__dachs_gc_expand_heap__",
+                    c.builder.getInt1Ty(),
+                    {c.builder.getInt64Ty()}
+                );
+        } else if (name == "__builtin_int_length") {
+            return emit_length_func(int_length_func, "__dachs_int_length__");
+        } else if (name == "__builtin_uint_length") {
+            return emit_length_func(uint_length_func, "__dachs_uint_length__");
+        } else if (name == "__builtin_format_int") {
+            return emit_format_integer_func(format_int_func, "__dachs_format_int__");
+        } else if (name == "__builtin_format_uint") {
+            return emit_format_integer_func(format_uint_func, "__dachs_format_uint__");
+        } else if (name == "__builtin_format_float") {
+            return emit_format_float_func();
+        } else if (name == "__builtin_parse_int") {
+            return emit_parse_int_func();
+        } else if (name == "__builtin_parse_float") {
+            return emit_parse_float_func();
+        } else if (name == "__builtin_read_line") {
+            return emit_read_string_func(read_line_func, "__dachs_read_line__");
+        } else if (name == "__builtin_read_token") {
+            return emit_read_string_func(read_token_func, "__dachs_read_token__");
+        } else if (name == "__builtin_read_all") {
+            return emit_read_string_func(read_all_func, "__dachs_read_all__");
+        } else if (name == "__builtin_read_char") {
+            return emit_read_char_func();
+        } else if (name == "__builtin_stdin_eof?") {
+            return emit_stdin_eof_func();
+        } else if (name == "__builtin_file_open") {
+            return emit_file_open_func();
+        } else if (name == "__builtin_file_close") {
+            return emit_file_handle_func(file_close_func, "__dachs_file_close__", c.builder.getInt1Ty());
+        } else if (name == "__builtin_file_flush") {
+            return emit_file_handle_func(file_flush_func, "__dachs_file_flush__", c.builder.getInt1Ty());
+        } else if (name == "__builtin_file_size") {
+            return emit_file_handle_func(file_size_func, "__dachs_file_size__", c.builder.getInt64Ty());
+        } else if (name == "__builtin_file_write") {
+            return emit_file_buffer_func(file_write_func, "__dachs_file_write__", c.builder.getInt1Ty());
+        } else if (name == "__builtin_file_read") {
+            return emit_file_buffer_func(file_read_func, "__dachs_file_read__", c.builder.getInt64Ty());
+        } else if (name == "__builtin_file_read_all") {
+            return emit_file_read_all_func();
+        } else if (name == "__builtin_mmap_read") {
+            return emit_mmap_read_func();
+        } else if (name == "__builtin_munmap") {
+            return emit_munmap_func();
+        } else if (name == "__builtin_next_line") {
+            return emit_next_line_func();
+        } else if (name == "__builtin_task_spawn") {
+            return emit_task_spawn_func(arg_types[0]);
+        } else if (name == "__builtin_task_join") {
+            return emit_task_join_func();
+        } else if (name == "__builtin_num_workers") {
+            return emit_num_workers_func();
+        } else if (name == "__builtin_ring_new") {
+            return emit_ring_func(ring_new_func, "__dachs_ring_new__");
+        } else if (name == "__builtin_ring_capacity") {
+            return emit_ring_func(ring_capacity_func, "__dachs_ring_capacity__");
+        } else if (name == "__builtin_ring_size") {
+            return emit_ring_func(ring_size_func, "__dachs_ring_size__");
+        } else if (name == "__builtin_ring_claim_push") {
+            return emit_ring_func(ring_claim_push_func, "__dachs_ring_claim_push__");
+        } else if (name == "__builtin_ring_claim_pop") {
+            return emit_ring_func(ring_claim_pop_func, "__dachs_ring_claim_pop__");
+        } else if (name == "__builtin_ring_try_claim_push") {
+            return emit_ring_func(ring_try_claim_push_func, "__dachs_ring_try_claim_push__");
+        } else if (name == "__builtin_ring_try_claim_pop") {
+            return emit_ring_func(ring_try_claim_pop_func, "__dachs_ring_try_claim_pop__");
+        } else if (name == "__builtin_ring_publish_push") {
+            return emit_unit_wrapped_func(
+                    ring_publish_push_func,
+                    "__builtin_ring_publish_push",
+                    "__dachs_ring_publish_push__",
+                    {c.builder.getInt64Ty(), c.builder.getInt64Ty()}
+                );
+        } else if (name == "__builtin_ring_release_pop") {
+            return emit_unit_wrapped_func(
+                    ring_release_pop_func,
+                    "__builtin_ring_release_pop",
+                    "__dachs_ring_release_pop__",
+                    {c.builder.getInt64Ty(), c.builder.getInt64Ty()}
+                );
+        } else if (name == "__builtin_spsc_new") {
+            return create_cached_func_prototype(spsc_new_func, "__dachs_spsc_new__", c.builder.getInt64Ty(), {});
+        } else if (name == "__builtin_spsc_empty?") {
+            return create_cached_func_prototype(spsc_empty_func, "__dachs_spsc_empty__", c.builder.getInt1Ty(), {c.builder.getInt64Ty()});
+        } else if (name == "__builtin_spsc_push") {
+            return emit_spsc_push_func(arg_types[1]);
+        } else if (name == "__builtin_spsc_try_pop") {
+            return emit_spsc_try_pop_func(arg_types[1]);
+        } else if (name == "__builtin_spsc_pop") {
+            return emit_spsc_pop_func(arg_types[1]);
+        } else if (name == "__builtin_arena_new") {
+            return create_cached_func_prototype(arena_new_func, "__dachs_arena_new__", c.builder.getInt64Ty(), {c.builder.getInt64Ty()});
+        } else if (name == "__builtin_arena_switch") {
+            return create_cached_func_prototype(arena_switch_func, "__dachs_arena_switch__", c.builder.getInt64Ty(), {c.builder.getInt64Ty()});
+        } else if (name == "__builtin_arena_allocated") {
+            return create_cached_func_prototype(arena_allocated_func, "__dachs_arena_allocated__", c.builder.getInt64Ty(), {c.builder.getInt64Ty()});
+        } else if (name == "__builtin_arena_release") {
+            return emit_unit_wrapped_func(
+                    arena_release_func,
+                    "__builtin_arena_release",
+                    "__dachs_arena_release__",
+                    {c.builder.getInt64Ty()}
+                );
         } // else ...
 
         return nullptr;
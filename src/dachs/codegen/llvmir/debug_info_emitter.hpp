@@ -0,0 +1,266 @@
+#if !defined DACHS_CODEGEN_LLVMIR_DEBUG_INFO_EMITTER_HPP_INCLUDED
+#define      DACHS_CODEGEN_LLVMIR_DEBUG_INFO_EMITTER_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Support/Dwarf.h>
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
+# include <llvm/DIBuilder.h>
+# include <llvm/DebugInfo.h>
+#elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
+# include <llvm/IR/DIBuilder.h>
+# include <llvm/IR/DebugInfo.h>
+#else
+# error LLVM: Not supported version.
+#endif
+
+#include "dachs/ast/ast.hpp"
+#include "dachs/semantics/scope.hpp"
+#include "dachs/codegen/debug_options.hpp"
+#include "dachs/codegen/llvmir/context.hpp"
+
+namespace dachs {
+namespace codegen {
+namespace llvmir {
+namespace detail {
+
+// Note:
+// Emit DWARF debug information with --debug-info.  Each Dachs function gets a
+// subprogram and each instruction gets the location of the AST node being
+// emitted.  Functions generated by the compiler (e.g. the entry point and
+// builtin wrappers) have no subprogram and their instructions have no location.
+class debug_info_emitter {
+    context &ctx;
+    llvm::Module &module;
+    debug_options const& options;
+    std::unique_ptr<llvm::DIBuilder> builder;
+    llvm::DICompileUnit compile_unit;
+    std::unordered_map<std::string, llvm::DIFile> file_table;
+    llvm::MDNode *current_subprogram = nullptr;
+    std::unordered_set<llvm::Function const*> described_funcs;
+
+    llvm::DIFile get_file(ast::location_type const& location)
+    {
+        auto const path = boost::filesystem::absolute(location.path ? location.get_path() : boost::filesystem::path{module.getModuleIdentifier()});
+        auto const path_str = path.string();
+
+        auto const itr = file_table.find(path_str);
+        if (itr != std::end(file_table)) {
+            return itr->second;
+        }
+
+        auto const file = builder->createFile(path.filename().string(), path.parent_path().string());
+        file_table.emplace(path_str, file);
+        return file;
+    }
+
+    // Note:
+    // IR names of functions are whole signatures.  Debuggers and profilers
+    // show this name instead.  Lambdas are named after their location because
+    // their names in the scope tree contain an address.
+    std::string get_readable_name(scope::func_scope const& scope, ast::location_type const& location) const
+    {
+        std::string name;
+        if (scope->is_anonymous()) {
+            name = "lambda@" + location.get_path().filename().string() + ':' + std::to_string(location.line) + ':' + std::to_string(location.col);
+        } else if (scope->is_ctor()) {
+            name = "init";
+        } else if (scope->is_copier()) {
+            name = "copy";
+        } else if (scope->is_converter()) {
+            name = "conv";
+        } else {
+            name = scope->name;
+        }
+
+        return name + '('
+            + boost::algorithm::join(
+                    scope->params | boost::adaptors::transformed([](auto const& p){ return p->type.to_string(); }),
+                    ", "
+                )
+            + ')';
+    }
+
+public:
+
+    debug_info_emitter(context &c, llvm::Module &m, debug_options const& o)
+        : ctx(c), module(m), options(o)
+    {
+        if (!options.debug_info) {
+            return;
+        }
+
+        builder = std::make_unique<llvm::DIBuilder>(module);
+
+        auto const path = boost::filesystem::absolute(module.getModuleIdentifier());
+
+        // Note:
+        // DWARF has no language code for Dachs.  C is used because it is
+        // understood by all debuggers and profilers.
+        compile_unit = builder->createCompileUnit(
+                llvm::dwarf::DW_LANG_C,
+                path.filename().string(),
+                path.parent_path().string(),
+                "Dachs compiler",
+                false /*isOptimized*/,
+                "" /*flags*/,
+                0u /*runtime version*/
+            );
+    }
+
+    bool enabled() const noexcept
+    {
+        return options.debug_info;
+    }
+
+    // Note:
+    // Called before the body of 'func' is emitted.  Locations set after this
+    // call belong to the function.
+    void emit_subprogram(llvm::Function *const func, scope::func_scope const& scope, ast::location_type const& location)
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        auto const file = get_file(location);
+        auto const line = static_cast<unsigned>(location.line);
+
+        // Note:
+        // Types of parameters are not described yet.  Only locations are needed
+        // for symbolization.
+        current_subprogram = builder->createFunction(
+                file,
+                get_readable_name(scope, location),
+                func->getName(),
+                file,
+                line,
+                builder->createSubroutineType(file, builder->getOrCreateArray({})),
+                false /*isLocalToUnit*/,
+                true /*isDefinition*/,
+                line,
+                0u /*flags*/,
+                false /*isOptimized*/,
+                func
+            );
+        described_funcs.insert(func);
+
+        ctx.builder.SetCurrentDebugLocation(
+                llvm::DebugLoc::get(line, static_cast<unsigned>(location.col), current_subprogram)
+            );
+    }
+
+    void exit_subprogram()
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        current_subprogram = nullptr;
+        ctx.builder.SetCurrentDebugLocation(llvm::DebugLoc{});
+    }
+
+    // Note:
+    // Set the location of the node being emitted to instructions until the
+    // returned guard is destroyed.  The location of the parent node is restored
+    // after that.
+    template<class Node>
+    auto enter_location(Node const& node)
+    {
+        struct location_guard {
+            llvm::IRBuilder<> *builder;
+            llvm::DebugLoc saved;
+
+            location_guard(location_guard const&) = delete;
+            location_guard(location_guard &&other) noexcept
+                : builder(other.builder), saved(other.saved)
+            {
+                other.builder = nullptr;
+            }
+
+            location_guard(llvm::IRBuilder<> *const b, llvm::DebugLoc const& s) noexcept
+                : builder(b), saved(s)
+            {}
+
+            ~location_guard() noexcept
+            {
+                if (builder) {
+                    builder->SetCurrentDebugLocation(saved);
+                }
+            }
+        };
+
+        if (!enabled() || !current_subprogram) {
+            return location_guard{nullptr, {}};
+        }
+
+        auto const location = ast::node::location_of(node);
+        if (location.line == 0u) {
+            return location_guard{nullptr, {}};
+        }
+
+        location_guard guard{&ctx.builder, ctx.builder.getCurrentDebugLocation()};
+        ctx.builder.SetCurrentDebugLocation(
+                llvm::DebugLoc::get(
+                    static_cast<unsigned>(location.line),
+                    static_cast<unsigned>(location.col),
+                    current_subprogram
+                )
+            );
+        return guard;
+    }
+
+    // Note:
+    // Called after all functions are emitted.  With --frame-pointer, the target
+    // machine is shared by all modules, so setting it once here is enough.
+    // "no-frame-pointer-elim" attribute is also added for the LLVM versions
+    // which see the attribute per function.
+    void finalize()
+    {
+        if (options.frame_pointer) {
+            ctx.target_machine->Options.NoFramePointerElim = true;
+            for (auto &f : module) {
+                if (!f.isDeclaration()) {
+                    f.addFnAttr("no-frame-pointer-elim", "true");
+                }
+            }
+        }
+
+        if (!enabled()) {
+            return;
+        }
+
+        // Note:
+        // Instructions emitted in compiler-generated functions may have a
+        // location of the Dachs function being emitted at that time.
+        for (auto &f : module) {
+            if (described_funcs.find(&f) != std::end(described_funcs)) {
+                continue;
+            }
+            for (auto &block : f) {
+                for (auto &inst : block) {
+                    inst.setDebugLoc(llvm::DebugLoc{});
+                }
+            }
+        }
+
+        builder->finalize();
+        module.addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
+    }
+};
+
+} // namespace detail
+} // namespace llvmir
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_LLVMIR_DEBUG_INFO_EMITTER_HPP_INCLUDED
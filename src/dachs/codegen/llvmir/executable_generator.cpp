@@ -2,6 +2,9 @@
 #include <string>
 #include <cstdlib>
 #include <cstdio>
+#include <fstream>
+#include <future>
+#include <memory>
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -14,11 +17,14 @@
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
 #include <llvm/Support/ToolOutputFile.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/Threading.h>
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR >= 5)
 # include <llvm/Support/FileSystem.h>
 #endif
 
 #include "dachs/codegen/llvmir/executable_generator.hpp"
+#include "dachs/codegen/llvmir/pgo.hpp"
+#include "dachs/codegen/llvmir/module_splitter.hpp"
 #include "dachs/exception.hpp"
 
 namespace dachs {
@@ -29,7 +35,12 @@ class binary_generator final {
 
     std::vector<llvm::Module *> modules;
     context &ctx;
+    helper::time_report &report;
+    helper::compile_stats &stats;
     opt_level opt;
+    pgo_options const& pgo;
+    runtime::pgo_profile profile;
+    std::size_t codegen_threads;
     llvm::PassManagerBuilder pm_builder;
 
     std::string get_base_name_from_module(llvm::Module const& module) const
@@ -49,14 +60,14 @@ class binary_generator final {
     }
 
     template<class PassManager>
-    void add_data_layout(PassManager &pm) const
+    void add_data_layout(PassManager &pm, llvm::DataLayout const& data_layout) const
     {
         // Note:
         // This implies that all passes MUST be allocated with 'new'.
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
-        pm.add(new llvm::DataLayout(*ctx.data_layout));
+        pm.add(new llvm::DataLayout(data_layout));
 #elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
-        pm.add(new llvm::DataLayoutPass(llvm::DataLayout(*ctx.data_layout)));
+        pm.add(new llvm::DataLayoutPass(llvm::DataLayout(data_layout)));
 #else
 # error LLVM: Not supported version.
 #endif
@@ -66,7 +77,7 @@ class binary_generator final {
     {
         llvm::FunctionPassManager pm{&module};
 
-        add_data_layout(pm);
+        add_data_layout(pm, *ctx.data_layout);
 
         pm_builder.populateFunctionPassManager(pm);
 
@@ -77,17 +88,40 @@ class binary_generator final {
         }
     }
 
-    bool run_module_passes(llvm::Module &module, llvm::formatted_raw_ostream &os)
+    void run_module_passes(llvm::Module &module)
     {
-        ctx.target_machine->setOptLevel(get_target_machine_opt_level());
-
         llvm::PassManager pm;
-        pm_builder.populateModulePassManager(pm);
 
         ctx.target_machine->addAnalysisPasses(pm);
-        add_data_layout(pm);
+        add_data_layout(pm, *ctx.data_layout);
+
+        pm_builder.populateModulePassManager(pm);
+
+        // Note:
+        // Instantiations of a template for types with the same representation
+        // (e.g. array(int) and array(uint), or classes which are all pointers)
+        // are identical after optimization.  They are merged after the module
+        // passes because the inliner would copy the body back into the thunk.
+        // Functions have external linkage, so a merged function remains as a
+        // thunk calling the other one and direct calls are redirected to it.
+        if (opt != opt_level::debug) {
+            pm.add(llvm::createMergeFunctionsPass());
+        }
+
+        pm.run(module);
+    }
 
-        if (ctx.target_machine->addPassesToEmitFile(pm, os, llvm::TargetMachine::CGFT_ObjectFile)) {
+    // Note:
+    // Module passes and target code generation are run by separate pass
+    // managers so that --time-report can show them separately.
+    bool run_codegen_passes(llvm::Module &module, llvm::TargetMachine &target_machine, llvm::formatted_raw_ostream &os)
+    {
+        llvm::PassManager pm;
+
+        target_machine.addAnalysisPasses(pm);
+        add_data_layout(pm, *target_machine.getDataLayout());
+
+        if (target_machine.addPassesToEmitFile(pm, os, llvm::TargetMachine::CGFT_ObjectFile)) {
             return false;
         }
 
@@ -96,13 +130,8 @@ class binary_generator final {
         return true;
     }
 
-    template<class String>
-    std::string generate_object(llvm::Module &module, String const parent_dir_path)
+    void emit_object_file(llvm::Module &module, llvm::TargetMachine &target_machine, std::string const& obj_name)
     {
-        run_func_passes(module);
-
-        auto const obj_name = parent_dir_path + get_base_name_from_module(module) + ".o";
-
         std::string buffer;
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
         llvm::tool_output_file out{obj_name.c_str(), buffer, llvm::sys::fs::F_None | llvm::sys::fs::F_Binary};
@@ -113,11 +142,140 @@ class binary_generator final {
 #endif
         out.keep(); // Do not delete object file
         llvm::formatted_raw_ostream formatted_os{out.os()};
-        if (!run_module_passes(module, formatted_os)) {
+        if (!run_codegen_passes(module, target_machine, formatted_os)) {
             throw code_generation_error{"LLVM IR generator", boost::format("Failed to create an object file '%1%': %2%") % obj_name % buffer};
         }
+    }
 
-        return obj_name;
+    static bool is_multithreaded()
+    {
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
+        return llvm::llvm_start_multithreaded();
+#elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
+        return llvm::llvm_is_multithreaded();
+#else
+# error LLVM: Not supported version.
+#endif
+    }
+
+    // Note:
+    // A target machine is not thread safe.  Each thread uses its own one with
+    // the same configuration as the shared one (e.g. --frame-pointer).
+    std::unique_ptr<llvm::TargetMachine> create_target_machine() const
+    {
+        std::unique_ptr<llvm::TargetMachine> target_machine{
+            ctx.target->createTargetMachine(
+                    ctx.triple.getTriple(),
+                    ctx.target_machine->getTargetCPU(),
+                    ctx.target_machine->getTargetFeatureString(),
+                    ctx.target_machine->Options,
+                    ctx.target_machine->getRelocationModel(),
+                    ctx.target_machine->getCodeModel(),
+                    get_target_machine_opt_level()
+                )
+        };
+
+        if (!target_machine) {
+            throw code_generation_error{"LLVM IR generator", boost::format("Failed to get a target machine for %1%") % ctx.triple.getTriple()};
+        }
+
+        return target_machine;
+    }
+
+    // Note:
+    // Code generation of each partition runs in its own thread with its own
+    // LLVMContext and target machine.  Nothing in LLVM is shared among them.
+    std::vector<std::string> generate_split_objects(detail::module_splitter const& splitter, std::string const& base_name)
+    {
+        std::vector<std::unique_ptr<llvm::TargetMachine>> target_machines;
+        for (std::size_t i = 0u; i < splitter.size(); ++i) {
+            target_machines.push_back(create_target_machine());
+        }
+
+        std::vector<std::future<std::string>> results;
+        for (std::size_t i = 0u; i < splitter.size(); ++i) {
+            results.push_back(
+                std::async(
+                    std::launch::async,
+                    [&, i]
+                    {
+                        llvm::LLVMContext llvm_context;
+                        auto const partition = splitter.extract(i, llvm_context);
+                        auto const obj_name = base_name + '.' + std::to_string(i) + ".o";
+                        emit_object_file(*partition, *target_machines[i], obj_name);
+                        return obj_name;
+                    }
+                )
+            );
+        }
+
+        std::vector<std::string> obj_names;
+        for (auto &r : results) {
+            obj_names.push_back(r.get());
+        }
+        return obj_names;
+    }
+
+    void record_func_sizes(llvm::Module const& module, bool const after_opt)
+    {
+        if (!stats.enabled()) {
+            return;
+        }
+
+        for (auto const& f : module) {
+            if (f.isDeclaration()) {
+                continue;
+            }
+
+            std::size_t num_insts = 0u;
+            for (auto const& block : f) {
+                num_insts += block.size();
+            }
+
+            if (after_opt) {
+                stats.record_size_after_opt(module.getModuleIdentifier(), f.getName().str(), num_insts);
+            } else {
+                stats.record_size_before_opt(module.getModuleIdentifier(), f.getName().str(), num_insts);
+            }
+        }
+    }
+
+    template<class String>
+    std::vector<std::string> generate_object(llvm::Module &module, String const parent_dir_path)
+    {
+        report.set_file(module.getModuleIdentifier());
+        record_func_sizes(module, false);
+
+        // Note:
+        // Counters are inserted and profiles are attached before any pass
+        // because the layout of counters is computed from the unoptimized IR.
+        if (!pgo.generate_file.empty()) {
+            report.measure("PGO instrumentation", [&]{ detail::pgo_instrumenter{ctx, module, pgo.generate_file}.instrument(); });
+        } else if (!pgo.use_file.empty()) {
+            report.measure("PGO annotation", [&]{ detail::pgo_annotator{profile}.annotate(module); });
+        }
+
+        report.measure("function passes", [&]{ run_func_passes(module); });
+        report.measure("module passes", [&]{ run_module_passes(module); });
+        record_func_sizes(module, true);
+
+        auto const base_name = parent_dir_path + get_base_name_from_module(module);
+
+        // Note:
+        // Partitions are split from the optimized module.  Optimization is not
+        // parallelized because the inliner needs the whole module.
+        if (codegen_threads > 1u && is_multithreaded()) {
+            auto const splitter = report.measure("module splitting", [&]{ return std::make_unique<detail::module_splitter>(module, codegen_threads); });
+            if (splitter->size() > 1u) {
+                return report.measure("code generation", [&]{ return generate_split_objects(*splitter, base_name); });
+            }
+        }
+
+        auto const obj_name = base_name + ".o";
+        ctx.target_machine->setOptLevel(get_target_machine_opt_level());
+        report.measure("code generation", [&]{ emit_object_file(module, *ctx.target_machine, obj_name); });
+
+        return {obj_name};
     }
 
     llvm::CodeGenOpt::Level get_target_machine_opt_level() const
@@ -135,11 +293,27 @@ class binary_generator final {
 
 public:
 
-    binary_generator(decltype(modules) const& ms, context &c, opt_level const o = opt_level::none)
-        : modules(ms), ctx(c), opt(o), pm_builder()
+    void optimize()
+    {
+        for (auto const m : modules) {
+            assert(m);
+            run_func_passes(*m);
+            run_module_passes(*m);
+        }
+    }
+
+    binary_generator(decltype(modules) const& ms, context &c, helper::time_report &r, helper::compile_stats &st, opt_level const o = opt_level::none, pgo_options const& p = {}, std::size_t const threads = 1u)
+        : modules(ms), ctx(c), report(r), stats(st), opt(o), pgo(p), profile(), codegen_threads(threads), pm_builder()
     {
         assert(!ms.empty());
 
+        if (!pgo.use_file.empty()) {
+            std::ifstream in{pgo.use_file};
+            if (!in || !profile.read(in)) {
+                throw code_generation_error{"LLVM IR generator", "Failed to read profile '" + pgo.use_file + "'"};
+            }
+        }
+
         switch (opt) {
         case opt_level::release:
             pm_builder.OptLevel = 3u;
@@ -188,7 +362,8 @@ public:
         std::vector<std::string> obj_names;
         for (auto const m : modules) {
             assert(m);
-            obj_names.push_back(generate_object(*m, parent_dir_path));
+            auto const objs = generate_object(*m, parent_dir_path);
+            obj_names.insert(std::end(obj_names), std::begin(objs), std::end(objs));
         }
         return obj_names;
     }
@@ -199,19 +374,21 @@ public:
         // TODO: Temporary
         auto const obj_names = generate_objects(parent_dir_path);
         auto const os_type = ctx.triple.getOS();
+        // Note: Objects are quoted one by one.  --codegen-threads makes several objects per module.
         auto const objs_string
-            = boost::algorithm::join(obj_names, " ");
+            = '"' + boost::algorithm::join(obj_names, "\" \"") + '"';
         auto const executable_name = parent_dir_path + get_base_name_from_module(*modules[0]);
         auto command
             = os_type == llvm::Triple::Darwin
-                ? "ld -macosx_version_min 10.9.0 \"" + objs_string + "\" -o \"" + executable_name + "\" -lSystem -ldachs-runtime -lgc -L /usr/lib -L /usr/local/lib -L " DACHS_INSTALL_PREFIX "/lib -L '" DACHS_LIBGC_PATH "'"
-                : (DACHS_CXX_COMPILER " ") + objs_string + " -o " + executable_name + " -ldachs-runtime -lgc -L /usr/lib -L /usr/local/lib -L " DACHS_INSTALL_PREFIX "/lib -L '" DACHS_LIBGC_PATH "'"; // Fallback...
+                ? "ld -macosx_version_min 10.9.0 " + objs_string + " -o \"" + executable_name + "\" -lSystem -ldachs-runtime -lgc -L /usr/lib -L /usr/local/lib -L " DACHS_INSTALL_PREFIX "/lib -L '" DACHS_LIBGC_PATH "'"
+                : (DACHS_CXX_COMPILER " ") + objs_string + " -o " + executable_name + " -ldachs-runtime -lgc -lpthread -L /usr/lib -L /usr/local/lib -L " DACHS_INSTALL_PREFIX "/lib -L '" DACHS_LIBGC_PATH "'"; // Fallback...
 
         for (auto const& lib : libdirs) {
             command += " -L \"" + lib + '"';
         }
 
-        int const cmd_result = std::system(command.c_str());
+        report.set_file("");
+        int const cmd_result = report.measure("link", [&]{ return std::system(command.c_str()); });
         if (WEXITSTATUS(cmd_result) != 0) {
             throw code_generation_error{"LLVM IR generator", boost::format("Linker command exited with status %1%. Command was: %2%") % WEXITSTATUS(cmd_result) % command};
         }
@@ -236,23 +413,42 @@ std::string generate_executable(
         std::vector<llvm::Module *> const& modules,
         std::vector<std::string> const& libdirs,
         context &ctx,
+        helper::time_report &report,
+        helper::compile_stats &stats,
         opt_level const opt,
+        pgo_options const& pgo,
+        std::size_t const codegen_threads,
         std::string parent)
 {
-    binary_generator generator{modules, ctx, opt};
+    binary_generator generator{modules, ctx, report, stats, opt, pgo, codegen_threads};
     return generator.generate_executable(libdirs, std::move(parent));
 }
 
 std::vector<std::string> generate_objects(
         std::vector<llvm::Module *> const& modules,
         context &ctx,
+        helper::time_report &report,
+        helper::compile_stats &stats,
         opt_level const opt,
+        pgo_options const& pgo,
+        std::size_t const codegen_threads,
         std::string parent)
 {
-    binary_generator generator{modules, ctx, opt};
+    binary_generator generator{modules, ctx, report, stats, opt, pgo, codegen_threads};
     return generator.generate_objects(std::move(parent));
 }
 
+void optimize_modules(
+        std::vector<llvm::Module *> const& modules,
+        context &ctx,
+        opt_level const opt)
+{
+    helper::time_report report;
+    helper::compile_stats stats;
+    binary_generator generator{modules, ctx, report, stats, opt};
+    generator.optimize();
+}
+
 } // namespace llvmir
 } // namespace codegen
 } // namespace dachs
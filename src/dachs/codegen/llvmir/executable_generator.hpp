@@ -1,6 +1,7 @@
 #if !defined DACHS_CODEGEN_LLVMIR_EXECUTABLE_GENERATOR_HPP_INCLUDED
 #define      DACHS_CODEGEN_LLVMIR_EXECUTABLE_GENERATOR_HPP_INCLUDED
 
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -8,6 +9,9 @@
 
 #include "dachs/codegen/llvmir/context.hpp"
 #include "dachs/codegen/opt_level.hpp"
+#include "dachs/codegen/pgo_options.hpp"
+#include "dachs/helper/time_report.hpp"
+#include "dachs/helper/compile_stats.hpp"
 
 namespace dachs {
 namespace codegen {
@@ -19,17 +23,33 @@ std::string generate_executable(
         std::vector<llvm::Module *> const& modules,
         std::vector<std::string> const& libdirs,
         context &ctx,
+        helper::time_report &report,
+        helper::compile_stats &stats,
         opt_level const opt = opt_level::none,
+        pgo_options const& pgo = {},
+        std::size_t const codegen_threads = 1u,
         std::string parent = ""
     );
 
 std::vector<std::string> generate_objects(
         std::vector<llvm::Module *> const& modules,
         context &ctx,
+        helper::time_report &report,
+        helper::compile_stats &stats,
         opt_level opt = opt_level::none,
+        pgo_options const& pgo = {},
+        std::size_t const codegen_threads = 1u,
         std::string parent = ""
     );
 
+// Note:
+// Run the same optimization passes as generate_objects() without generating objects.
+void optimize_modules(
+        std::vector<llvm::Module *> const& modules,
+        context &ctx,
+        opt_level const opt = opt_level::none
+    );
+
 } // namespace llvmir
 } // namespace codegen
 } // namespace dachs
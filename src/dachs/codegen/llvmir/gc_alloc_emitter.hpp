@@ -2,8 +2,10 @@
 #define      DACHS_CODEGEN_LLVMIR_GC_ALLOC_EMITTER_HPP_INCLUDED
 
 #include <cassert>
+#include <cstddef>
 #include <initializer_list>
 #include <unordered_map>
+#include <string>
 
 #include <llvm/IR/Value.h>
 #include <llvm/IR/DerivedTypes.h>
@@ -11,21 +13,23 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Function.h>
 
+#include "dachs/ast/ast.hpp"
 #include "dachs/semantics/type.hpp"
+#include "dachs/codegen/gc_options.hpp"
 
 namespace dachs {
 namespace codegen {
 namespace llvmir {
 namespace detail {
 
-// Note:
-// Should I define our original malloc() and realloc() in runtime?
-
 class gc_alloc_emitter {
     context &ctx;
     type_ir_emitter &type_emitter;
     llvm::Module &module;
+    gc_options const& options;
     std::unordered_map<std::string, llvm::Function *> func_table;
+    ast::location_type site;
+    std::unordered_map<std::string, llvm::Value *> site_table;
 
     using val = llvm::Value *;
 
@@ -57,19 +61,49 @@ class gc_alloc_emitter {
         return func;
     }
 
+    // Note:
+    // Runtime allocation functions.  They allocate in the current arena (std.arena)
+    // if set.  Otherwise they call GC_malloc(), GC_realloc() and GC_free().
     llvm::Function *create_malloc_func()
     {
         return create_func(
-                "GC_malloc",
+                "__dachs_malloc__",
                 ctx.builder.getInt8PtrTy(),
                 {ctx.builder.getIntPtrTy(ctx.data_layout)}
             );
     }
 
+    // Note:
+    // Allocation function for small objects of a fixed size.  It uses thread-local
+    // free lists in runtime.  The size must be equal to or less than small_alloc_max_size.
+    llvm::Function *create_small_malloc_func()
+    {
+        return create_func(
+                "__dachs_malloc_small__",
+                ctx.builder.getInt8PtrTy(),
+                {ctx.builder.getIntPtrTy(ctx.data_layout)}
+            );
+    }
+
+    // Note:
+    // Same as alloc_cache_max_size in runtime
+    static constexpr std::size_t small_alloc_max_size = 256u;
+
+    llvm::Function *choose_malloc_func(llvm::Type *const elem_ty, val const size_value)
+    {
+        if (auto *const const_size = llvm::dyn_cast<llvm::ConstantInt>(size_value)) {
+            auto const bytes = ctx.data_layout->getTypeAllocSize(elem_ty) * const_size->getZExtValue();
+            if (bytes <= small_alloc_max_size) {
+                return create_small_malloc_func();
+            }
+        }
+        return create_malloc_func();
+    }
+
     llvm::Function *create_realloc_func()
     {
         return create_func(
-                "GC_realloc",
+                "__dachs_realloc__",
                 ctx.builder.getInt8PtrTy(),
                 {
                     ctx.builder.getInt8PtrTy(),
@@ -78,27 +112,105 @@ class gc_alloc_emitter {
             );
     }
 
+    // Note:
+    // Runtime function which calls GC_init() with the settings of gc_options
     llvm::Function *create_gc_init_func()
     {
         return create_func(
-                "GC_init",
+                "__dachs_gc_init__",
+                ctx.builder.getVoidTy(),
+                {
+                    ctx.builder.getInt64Ty(),
+                    ctx.builder.getInt1Ty(),
+                    ctx.builder.getInt64Ty(),
+                    ctx.builder.getInt64Ty()
+                }
+            );
+    }
+
+    llvm::Function *create_heap_profile_init_func()
+    {
+        return create_func(
+                "__dachs_heap_profile_init__",
                 ctx.builder.getVoidTy(),
                 {}
             );
     }
 
+    // Note:
+    // Used instead of GC_malloc() with --heap-profile.  It receives the allocation site.
+    llvm::Function *create_profiled_malloc_func()
+    {
+        return create_func(
+                "__dachs_profiled_malloc__",
+                ctx.builder.getInt8PtrTy(),
+                {
+                    ctx.builder.getIntPtrTy(ctx.data_layout),
+                    ctx.builder.getInt8PtrTy()
+                }
+            );
+    }
+
+    llvm::Value *emit_site_string()
+    {
+        auto site_str
+            = site.empty()
+                ? std::string{"<unknown>"}
+                : site.get_path().native() + ':' + std::to_string(site.line) + ':' + std::to_string(site.col);
+
+        auto const itr = site_table.find(site_str);
+        if (itr != std::end(site_table)) {
+            return itr->second;
+        }
+
+        auto *const str = ctx.builder.CreateGlobalStringPtr(site_str, "heap.site");
+        site_table.emplace(std::move(site_str), str);
+        return str;
+    }
+
     llvm::Function *create_free_func()
     {
         return create_func(
-                "GC_free",
+                "__dachs_free__",
                 ctx.builder.getVoidTy(),
                 {ctx.builder.getInt8PtrTy()}
             );
     }
 
+    template<class String>
+    val create_profiled_malloc_call(llvm::BasicBlock *const insert_end, llvm::Type *const elem_ty, val const size_value, String const& name)
+    {
+        auto *const intptr_ty = ctx.builder.getIntPtrTy(ctx.data_layout);
+        auto *const elem_size_value = llvm::ConstantInt::get(intptr_ty, ctx.data_layout->getTypeAllocSize(elem_ty));
+
+        auto *const alloc_size_value
+            = llvm::BinaryOperator::CreateMul(size_value, elem_size_value, "malloc.size");
+        insert_end->getInstList().push_back(alloc_size_value);
+
+        auto *const allocated
+            = llvm::CallInst::Create(
+                    create_profiled_malloc_func(),
+                    {
+                        alloc_size_value,
+                        emit_site_string()
+                    },
+                    "malloc.call"
+                );
+        insert_end->getInstList().push_back(allocated);
+
+        auto *const casted = create_bit_cast(allocated, elem_ty->getPointerTo(), insert_end);
+        casted->setName(name);
+
+        return casted;
+    }
+
     template<class String>
     val create_malloc_call(llvm::BasicBlock *const insert_end, llvm::Type *const elem_ty, val const size_value, String const& name)
     {
+        if (options.heap_profile) {
+            return create_profiled_malloc_call(insert_end, elem_ty, size_value, name);
+        }
+
         auto *const intptr_ty = ctx.builder.getIntPtrTy(ctx.data_layout);
         auto *const emitted
             = llvm::CallInst::CreateMalloc(
@@ -107,7 +219,7 @@ class gc_alloc_emitter {
                     elem_ty,
                     llvm::ConstantInt::get(intptr_ty, ctx.data_layout->getTypeAllocSize(elem_ty)),
                     size_value,
-                    create_malloc_func(),
+                    choose_malloc_func(elem_ty, size_value),
                     "malloc.call"
                 );
         ctx.builder.Insert(emitted);
@@ -193,10 +305,48 @@ class gc_alloc_emitter {
 
 public:
 
-    gc_alloc_emitter(context &c, type_ir_emitter &e, llvm::Module &m) noexcept
-        : ctx(c), type_emitter(e), module(m)
+    gc_alloc_emitter(context &c, type_ir_emitter &e, llvm::Module &m, gc_options const& o) noexcept
+        : ctx(c), type_emitter(e), module(m), options(o)
     {}
 
+    // Note:
+    // Set the location of the node being emitted.  With --heap-profile,
+    // allocations are attributed to it until the returned guard is destroyed.
+    template<class Node>
+    auto enter_site(Node const& node)
+    {
+        struct site_guard {
+            gc_alloc_emitter *emitter;
+            ast::location_type saved;
+
+            site_guard(site_guard const&) = delete;
+            site_guard(site_guard &&other) noexcept
+                : emitter(other.emitter), saved(std::move(other.saved))
+            {
+                other.emitter = nullptr;
+            }
+
+            site_guard(gc_alloc_emitter *const e, ast::location_type &&s) noexcept
+                : emitter(e), saved(std::move(s))
+            {}
+
+            ~site_guard() noexcept
+            {
+                if (emitter) {
+                    emitter->site = std::move(saved);
+                }
+            }
+        };
+
+        if (!options.heap_profile) {
+            return site_guard{nullptr, {}};
+        }
+
+        auto saved = std::move(site);
+        site = ast::node::location_of(node);
+        return site_guard{this, std::move(saved)};
+    }
+
     template<class String = char const*>
     val emit_malloc(type::type const& elem_type, std::size_t const array_size, String const& name = "")
     {
@@ -250,13 +400,33 @@ public:
         return emit_malloc(elem_type, 1u, name);
     }
 
+    // Note:
+    // Allocate one object of IR type 'ty'.  Used for a block which contains
+    // an object and its nested objects.
     template<class String = char const*>
-    val emit_alloc(type::type const& elem_type, String const& name = "")
+    val emit_malloc_block(llvm::Type *const ty, String const& name = "")
+    {
+        return create_malloc_call(
+                ctx.builder.GetInsertBlock(),
+                ty,
+                llvm::ConstantInt::get(ctx.builder.getIntPtrTy(ctx.data_layout), 1u),
+                name
+            );
+    }
+
+    // Note:
+    // Primitive types are treated by value.  No need to allocate them in heap.
+    // Memory allocated in heap is always zero-cleared by runtime (GC_malloc(),
+    // free lists filled by GC_malloc_many() and arenas).
+    bool allocates_in_heap(type::type const& elem_type) const noexcept
     {
-        // Note:
-        // Primitive types are treated by value.  No need to allocate them in heap.
+        return elem_type.is_aggregate();
+    }
 
-        if (elem_type.is_aggregate()) {
+    template<class String = char const*>
+    val emit_alloc(type::type const& elem_type, String const& name = "")
+    {
+        if (allocates_in_heap(elem_type)) {
             return emit_malloc(elem_type, name);
         } else {
             return ctx.builder.CreateAlloca(type_emitter.emit_alloc_type(elem_type), nullptr, name);
@@ -300,10 +470,20 @@ public:
             );
     }
 
-    val emit_init()
+    void emit_init()
     {
         auto *const gc_init = create_gc_init_func();
-        return ctx.builder.CreateCall(gc_init);
+        ctx.builder.CreateCall4(
+                gc_init,
+                ctx.builder.getInt64(options.markers),
+                ctx.builder.getInt1(options.incremental),
+                ctx.builder.getInt64(options.initial_heap_size),
+                ctx.builder.getInt64(options.free_space_divisor)
+            );
+
+        if (options.heap_profile) {
+            ctx.builder.CreateCall(create_heap_profile_init_func());
+        }
     }
 
     val emit_free(val const ptr_value)
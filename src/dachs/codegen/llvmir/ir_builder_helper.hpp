@@ -2,6 +2,7 @@
 #define      DACHS_CODEGEN_LLVMIR_IR_BUILDER_HELPER_HPP_INCLUDED
 
 #include <memory>
+#include <vector>
 #include <algorithm>
 #include <utility>
 #include <cstddef>
@@ -388,14 +389,127 @@ public:
         return gc_emitter.emit_alloc(t, name);
     }
 
+    // Note:
+    // Fields of class and tuple type which are allocated with the object.
+    // Returns pairs of the field type and its index.
+    std::vector<std::pair<type::type, unsigned>> aggregate_fields_of(type::type const& t) const
+    {
+        std::vector<std::pair<type::type, unsigned>> fields;
+
+        if (auto const tuple = type::get<type::tuple_type>(t)) {
+            for (auto const idx : helper::indices((*tuple)->element_types)) {
+                auto const& elem_type = (*tuple)->element_types[idx];
+                if (elem_type.is_aggregate()) {
+                    fields.emplace_back(elem_type, idx);
+                }
+            }
+        } else if (auto const clazz = type::get<type::class_type>(t)) {
+            auto const scope = (*clazz)->ref.lock();
+            assert(!scope->is_template());
+            for (auto const idx : helper::indices(scope->instance_var_symbols)) {
+                auto const& var_type = scope->instance_var_symbols[idx]->type;
+                if (var_type.is_aggregate()) {
+                    fields.emplace_back(var_type, idx);
+                }
+            }
+        }
+
+        return fields;
+    }
+
+    // Note:
+    // A nested object is placed in the heap block of its parent when it is
+    // never shared.  Instance variables and tuple elements are deep-copied on
+    // assignment, so the pointer to the nested object is never replaced except
+    // for classes with a user-defined copier.  They keep their own allocation.
+    bool is_inlinable_field(type::type const& t) const
+    {
+        return (type::is_a<type::class_type>(t) || type::is_a<type::tuple_type>(t))
+            && !semantics_ctx.copier_of(t);
+    }
+
+    bool has_inlinable_fields(type::type const& t) const
+    {
+        auto const fields = aggregate_fields_of(t);
+        return std::any_of(
+                std::begin(fields),
+                std::end(fields),
+                [this](auto const& f){ return is_inlinable_field(f.first); }
+            );
+    }
+
+    // Note:
+    // {object, block of the 1st inlined field, block of the 2nd inlined field, ...}
+    // The object still refers to nested objects by pointer.  So the layout of
+    // the object and accesses to its fields are unchanged.
+    llvm::StructType *emit_inline_block_type(type::type const& t)
+    {
+        std::vector<llvm::Type *> elem_tys = {type_emitter.emit_alloc_type(t)};
+        for (auto const& f : aggregate_fields_of(t)) {
+            if (is_inlinable_field(f.first)) {
+                elem_tys.push_back(emit_inline_block_type(f.first));
+            }
+        }
+        return llvm::StructType::get(ctx.llvm_context, elem_tys);
+    }
+
+    // Note:
+    // Link the object in 'block' to its nested objects in the same block and
+    // return the object.
+    llvm::Value *link_inline_block(llvm::Value *const block, type::type const& t, bool const init_by_zero)
+    {
+        auto *const obj = ctx.builder.CreateStructGEP(block, 0u);
+
+        unsigned block_idx = 1u;
+        for (auto const& f : aggregate_fields_of(t)) {
+            auto *const nested
+                = is_inlinable_field(f.first)
+                    ? link_inline_block(ctx.builder.CreateStructGEP(block, block_idx++), f.first, init_by_zero)
+                    : create_alloca(f.first, init_by_zero);
+
+            ctx.builder.CreateStore(
+                    nested,
+                    ctx.builder.CreateStructGEP(obj, f.second)
+                );
+        }
+
+        return obj;
+    }
+
+    // Note:
+    // Allocate a class or tuple object and its nested objects by one allocation.
+    // Heap memory is already zero-cleared.
+    template<class String>
+    llvm::Value *create_inline_alloca(type::type const& t, bool const init_by_zero, String const& name)
+    {
+        auto *const block = gc_emitter.emit_malloc_block(emit_inline_block_type(t), "inline.block");
+        auto *const obj = link_inline_block(block, t, init_by_zero);
+        obj->setName(name);
+        return obj;
+    }
+
+    // Note:
+    // Static arrays and primitive values are allocated on stack.
+    bool is_zero_cleared_alloc(type::type const& t) const noexcept
+    {
+        return !type::is_a<type::array_type>(t) && gc_emitter.allocates_in_heap(t);
+    }
+
     // TODO:
     // Use visitor which visits type::type
     template<class String = char const* const>
     llvm::Value *create_alloca(type::type const& t, bool const init_by_zero = true, String const& name = "")
     {
+        if (has_inlinable_fields(t)) {
+            return create_inline_alloca(t, init_by_zero, name);
+        }
+
         auto *const allocated = create_alloca_impl(t, name);
 
-        if (init_by_zero) {
+        // Note:
+        // Memory allocated in heap is already zero-cleared.  Clearing it again
+        // would touch every constructed object twice.
+        if (init_by_zero && !is_zero_cleared_alloc(t)) {
             create_memset(allocated, allocated->getType(), t);
         }
 
@@ -474,6 +588,28 @@ public:
         return allocated;
     }
 
+    // Note:
+    // Allocate a tuple or class object on stack.  The alloca is placed in the entry
+    // block so that the stack does not grow in a loop.  Nested aggregate objects
+    // are still allocated in heap at each call.  Fields are not zero-cleared
+    // because the caller must store all of them.
+    template<class String = char const* const>
+    llvm::Value *create_stack_alloca(type::type const& t, String const& name = "")
+    {
+        auto &entry = ctx.builder.GetInsertBlock()->getParent()->getEntryBlock();
+        llvm::IRBuilder<> entry_builder{&entry, entry.begin()};
+        auto *const allocated = entry_builder.CreateAlloca(type_emitter.emit_alloc_type(t), nullptr /*size*/, name);
+
+        for (auto const& f : aggregate_fields_of(t)) {
+            ctx.builder.CreateStore(
+                    create_alloca(f.first),
+                    ctx.builder.CreateStructGEP(allocated, f.second)
+                );
+        }
+
+        return allocated;
+    }
+
     template<class V, class String = char const* const>
     llvm::Value *alloc_and_deep_copy(V *const from, type::type const& t, String const& name = "")
     {
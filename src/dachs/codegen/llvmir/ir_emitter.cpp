@@ -25,6 +25,7 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
 # include <llvm/Analysis/Verifier.h>
 #elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
@@ -43,6 +44,7 @@
 #include "dachs/codegen/llvmir/ir_emitter.hpp"
 #include "dachs/codegen/llvmir/type_ir_emitter.hpp"
 #include "dachs/codegen/llvmir/gc_alloc_emitter.hpp"
+#include "dachs/codegen/llvmir/debug_info_emitter.hpp"
 #include "dachs/codegen/llvmir/tmp_builtin_operator_ir_emitter.hpp"
 #include "dachs/codegen/llvmir/builtin_func_ir_emitter.hpp"
 #include "dachs/codegen/llvmir/ir_builder_helper.hpp"
@@ -85,6 +87,9 @@ class llvm_ir_emitter {
     var_table_type var_table;
     std::unordered_map<scope::func_scope, llvm::Function *const> func_table;
     std::string const& file;
+    gc_options const& gc_opts;
+    debug_options const& debug_opts;
+    instrumentation_options const& instr_opts;
     std::stack<llvm::BasicBlock *> loop_stack; // Loop stack for continue and break statements
     type_ir_emitter type_emitter;
     gc_alloc_emitter gc_emitter;
@@ -94,6 +99,14 @@ class llvm_ir_emitter {
     builder::inst_emit_helper inst_emitter;
     builtin_function_emitter builtin_func_emitter;
     tmp_constructor_ir_emitter<llvm_ir_emitter> builtin_ctor_emitter;
+    debug_info_emitter debug_info;
+
+    // Note:
+    // Names of the functions instrumented by --profile-functions.  The index
+    // is the slot of the function in this module.  The first slot of the module
+    // in the runtime is stored to 'profile_base' by the module constructor.
+    std::vector<std::string> profiled_funcs;
+    llvm::GlobalVariable *profile_base = nullptr;
 
     val lookup_var(symbol::var_symbol const& s) const
     {
@@ -169,6 +182,8 @@ class llvm_ir_emitter {
     template<class... NodeTypes>
     auto emit(boost::variant<NodeTypes...> const& ns)
     {
+        auto const site_guard = gc_emitter.enter_site(ns);
+        auto const location_guard = debug_info.enter_location(ns);
         return apply_lambda([this](auto const& n){ return emit(n); }, ns);
     }
 
@@ -217,6 +232,10 @@ class llvm_ir_emitter {
             {
                 gc_emitter.emit_init();
 
+                if (instr_opts.profile_functions) {
+                    ctx.builder.CreateCall(builtin_func_emitter.emit_function_profile_init_func());
+                }
+
                 if (!has_cmdline_arg) {
                     return ctx.builder.CreateCall(
                             main_func_value,
@@ -353,9 +372,7 @@ class llvm_ir_emitter {
         auto const is_supported
             = [](auto const& t)
             {
-                    return t->name == "int"
-                        || t->name == "float"
-                        || t->name == "uint"
+                    return t->is_numeric()
                         || t->name == "bool"
                         || t->name == "char"
                         || t->name == "symbol"
@@ -621,23 +638,27 @@ class llvm_ir_emitter {
 
 public:
 
-    llvm_ir_emitter(std::string const& f, context &c, semantics::semantics_context const& sc, llvm::Module &m)
+    llvm_ir_emitter(std::string const& f, context &c, semantics::semantics_context const& sc, gc_options const& g, debug_options const& d, instrumentation_options const& i, llvm::Module &m)
         : module(&m)
         , ctx(c)
         , semantics_ctx(sc)
         , var_table()
         , file(f)
+        , gc_opts(g)
+        , debug_opts(d)
+        , instr_opts(i)
         , type_emitter(ctx.llvm_context, sc.lambda_captures)
-        , gc_emitter(c, type_emitter, *module)
+        , gc_emitter(c, type_emitter, *module, gc_opts)
         , member_emitter(ctx)
         , alloc_helper(ctx, type_emitter, gc_emitter, sc.lambda_captures, semantics_ctx, m)
         , inst_emitter(ctx, type_emitter, m)
         , builtin_func_emitter(m, ctx, type_emitter, gc_emitter, inst_emitter)
         , builtin_ctor_emitter(ctx, type_emitter, gc_emitter, alloc_helper, module, *this)
+        , debug_info(ctx, m, debug_opts)
     {}
 
-    llvm_ir_emitter(std::string const& f, context &c, semantics::semantics_context const& sc)
-        : llvm_ir_emitter(f, c, sc, *new llvm::Module(f, c.llvm_context))
+    llvm_ir_emitter(std::string const& f, context &c, semantics::semantics_context const& sc, gc_options const& g, debug_options const& d, instrumentation_options const& i)
+        : llvm_ir_emitter(f, c, sc, g, d, i, *new llvm::Module(f, c.llvm_context))
     {
         module->setDataLayout(ctx.data_layout->getStringRepresentation());
         module->setTargetTriple(ctx.triple.getTriple());
@@ -674,7 +695,13 @@ public:
 
             val operator()(double const d)
             {
-                return llvm::ConstantFP::get(c.llvm_context, llvm::APFloat(d));
+                if (pl->suffix.empty()) {
+                    return llvm::ConstantFP::get(c.llvm_context, llvm::APFloat(d));
+                } else {
+                    // Note:
+                    // Rounded to the precision of the suffix type (e.g. f32)
+                    return llvm::ConstantFP::get(t_emitter.emit(pl->type), d);
+                }
             }
 
             val operator()(bool const b)
@@ -708,7 +735,7 @@ public:
         return check(pl, boost::apply_visitor(visitor, pl->value), "constant");
     }
 
-    val emit_tuple_constant(type::tuple_type const& t, std::vector<ast::node::any_expr> const& elem_exprs)
+    val emit_tuple_constant(type::tuple_type const& t, std::vector<ast::node::any_expr> const& elem_exprs, bool const on_stack = false)
     {
         if (elem_exprs.empty()) {
             return inst_emitter.emit_unit_constant();
@@ -742,7 +769,10 @@ public:
             return constant;
         } else {
             // XXX
-            auto *const alloca_inst = alloc_helper.create_alloca(t);
+            auto *const alloca_inst
+                = on_stack
+                    ? alloc_helper.create_stack_alloca(t)
+                    : alloc_helper.create_alloca(t);
 
             for (auto const idx : helper::indices(elem_values)) {
                 auto const elem_type = type::type_of(elem_exprs[idx]);
@@ -891,7 +921,24 @@ public:
 
     val emit(ast::node::lambda_expr const& lambda)
     {
-        return emit(lambda->receiver);
+        auto const& receiver = lambda->receiver;
+        if (!semantics_ctx.is_stack_lambda_receiver(receiver)) {
+            return emit(receiver);
+        }
+
+        // Note:
+        // The lambda never outlives the invocation it is passed to.
+        // Its capture struct is allocated on stack.
+        assert(type::is_a<type::tuple_type>(receiver->type));
+        return check(
+                receiver,
+                emit_tuple_constant(
+                    *type::get<type::tuple_type>(receiver->type),
+                    receiver->element_exprs,
+                    true /*on stack*/
+                ),
+                "lambda receiver"
+            );
     }
 
     llvm::Module *emit(ast::node::inu const& p)
@@ -915,6 +962,12 @@ public:
         emit_defs(p->global_constants);
         emit_defs(p->functions);
 
+        if (!profiled_funcs.empty()) {
+            emit_function_profile_registration();
+        }
+
+        debug_info.finalize();
+
         assert(loop_stack.empty());
 
         return module;
@@ -1004,6 +1057,81 @@ public:
         }
     }
 
+    // Note:
+    // With --profile-functions, a function notifies the runtime of its slot at
+    // its entry and notifies the runtime before each return.  All returns are
+    // emitted by then, so they are found by looking at the terminators of the
+    // blocks.
+    void emit_function_profile(llvm::Function *const func_ir, std::string const& name)
+    {
+        if (!profile_base) {
+            profile_base = new llvm::GlobalVariable(
+                    *module,
+                    ctx.builder.getInt64Ty(),
+                    false /*constant*/,
+                    llvm::GlobalValue::PrivateLinkage,
+                    ctx.builder.getInt64(0u),
+                    "dachs.profile.base"
+                );
+        }
+
+        auto const slot = profiled_funcs.size();
+        profiled_funcs.push_back(name);
+
+        auto &entry = func_ir->getEntryBlock();
+        ctx.builder.SetInsertPoint(&entry, entry.getFirstInsertionPt());
+        ctx.builder.CreateCall(
+                builtin_func_emitter.emit_function_enter_func(),
+                ctx.builder.CreateAdd(ctx.builder.CreateLoad(profile_base), ctx.builder.getInt64(slot), "dachs.profile.slot")
+            );
+
+        for (auto &block : *func_ir) {
+            if (auto *const ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(block.getTerminator())) {
+                ctx.builder.SetInsertPoint(ret);
+                ctx.builder.CreateCall(builtin_func_emitter.emit_function_exit_func());
+            }
+        }
+    }
+
+    // Note:
+    // The module constructor registers the names of the instrumented functions
+    // to the runtime and receives the first slot of the module.
+    void emit_function_profile_registration()
+    {
+        auto *const ctor = llvm::Function::Create(
+                llvm::FunctionType::get(ctx.builder.getVoidTy(), false),
+                llvm::Function::InternalLinkage,
+                "dachs.profile.init",
+                module
+            );
+        ctx.builder.SetInsertPoint(llvm::BasicBlock::Create(ctx.llvm_context, "entry", ctor));
+
+        std::vector<llvm::Constant *> names;
+        for (auto const& f : profiled_funcs) {
+            names.push_back(llvm::cast<llvm::Constant>(ctx.builder.CreateGlobalStringPtr(f, "dachs.profile.name")));
+        }
+
+        auto *const names_ty = llvm::ArrayType::get(ctx.builder.getInt8PtrTy(), names.size());
+        auto *const names_table = new llvm::GlobalVariable(
+                *module,
+                names_ty,
+                true /*constant*/,
+                llvm::GlobalValue::PrivateLinkage,
+                llvm::ConstantArray::get(names_ty, names),
+                "dachs.profile.names"
+            );
+
+        auto *const first_slot = ctx.builder.CreateCall2(
+                builtin_func_emitter.emit_function_profile_register_func(),
+                ctx.builder.CreateConstInBoundsGEP2_64(names_table, 0u, 0u),
+                ctx.builder.getInt64(names.size())
+            );
+        ctx.builder.CreateStore(first_slot, profile_base);
+        ctx.builder.CreateRetVoid();
+
+        llvm::appendToGlobalCtors(*module, ctor, 0);
+    }
+
     // Note:
     // IR for the function prototype is already emitd in emit(ast::node::inu const&)
     void emit(ast::node::function_definition const& func_def)
@@ -1022,6 +1150,7 @@ public:
         auto const& prototype_ir = *maybe_prototype_ir;
         auto const block = llvm::BasicBlock::Create(ctx.llvm_context, "entry", prototype_ir);
         ctx.builder.SetInsertPoint(block);
+        debug_info.emit_subprogram(prototype_ir, scope, func_def->location);
 
         for (auto const& p : func_def->params) {
             emit(p);
@@ -1048,6 +1177,12 @@ public:
             ctx.builder.CreateUnreachable();
         }
 
+        if (instr_opts.profile_functions) {
+            emit_function_profile(prototype_ir, scope->to_string());
+        }
+
+        debug_info.exit_subprogram();
+
         if (scope->is_main_func()) {
             assert(scope->ret_type);
             emit_program_entry_point(prototype_ir, !scope->params.empty(), *scope->ret_type);
@@ -1416,8 +1551,8 @@ public:
             auto const& builtin = *b;
             auto const& name = builtin->name;
 
-            if (name != "int" && name != "float" && name != "bool" && name != "uint") {
-                error(unary, "Unary expression now only supports float, int, bool and uint");
+            if (!builtin->is_numeric() && name != "bool") {
+                error(unary, "Unary expression now only supports numeric types and bool");
             }
 
             return check(
@@ -2349,33 +2484,32 @@ public:
                 return check(cast, v, "cast from " + from + " to " + to);
             };
 
-        if (from == "int") {
-            if (to == "uint") {
-                return child_val; // Note: Do nothing.
-            } else if (to == "float") {
-                return cast_check(ctx.builder.CreateSIToFP(child_val, to_type_ir));
-            } else if (to == "char") {
-                return cast_check(ctx.builder.CreateTrunc(child_val, to_type_ir));
-            }
-        } else if (from == "uint") {
-            if (to == "int") {
-                return child_val; // Note: Do nothing
-            } else if (to == "float") {
-                return cast_check(ctx.builder.CreateUIToFP(child_val, to_type_ir));
-            } else if (to == "char") {
-                return cast_check(ctx.builder.CreateTrunc(child_val, to_type_ir));
-            }
-        } else if (from == "float") {
-            if (to == "int" || to == "char") {
-                return cast_check(ctx.builder.CreateFPToSI(child_val, to_type_ir));
-            } else if (to == "uint") {
-                return cast_check(ctx.builder.CreateFPToUI(child_val, to_type_ir));
+        // Note:
+        // 'char' is treated as a signed 8-bit integer
+        auto const is_integral = [](auto const& t){ return t->is_integer() || t->name == "char"; };
+        auto const is_signed = [](auto const& t){ return t->is_signed_integer() || t->name == "char"; };
+
+        if (is_integral(from_type)) {
+            if (is_integral(to_type)) {
+                // Note:
+                // Do nothing between integers of the same width (e.g. int and uint)
+                return cast_check(ctx.builder.CreateIntCast(child_val, to_type_ir, is_signed(from_type)));
+            } else if (to_type->is_floating_point()) {
+                return cast_check(
+                        is_signed(from_type)
+                            ? ctx.builder.CreateSIToFP(child_val, to_type_ir)
+                            : ctx.builder.CreateUIToFP(child_val, to_type_ir)
+                    );
             }
-        } else if (from == "char") {
-            if (to == "int" || to == "uint") {
-                return cast_check(ctx.builder.CreateSExt(child_val, to_type_ir));
-            } else if (to == "float") {
-                return cast_check(ctx.builder.CreateSIToFP(child_val, to_type_ir));
+        } else if (from_type->is_floating_point()) {
+            if (is_integral(to_type)) {
+                return cast_check(
+                        is_signed(to_type)
+                            ? ctx.builder.CreateFPToSI(child_val, to_type_ir)
+                            : ctx.builder.CreateFPToUI(child_val, to_type_ir)
+                    );
+            } else if (to_type->is_floating_point()) {
+                return cast_check(ctx.builder.CreateFPCast(child_val, to_type_ir));
             }
         }
 
@@ -2425,9 +2559,9 @@ public:
 
 } // namespace detail
 
-llvm::Module &emit_llvm_ir(ast::ast const& a, semantics::semantics_context const& sctx, context &ctx)
+llvm::Module &emit_llvm_ir(ast::ast const& a, semantics::semantics_context const& sctx, context &ctx, gc_options const& gc_opts, debug_options const& debug_opts, instrumentation_options const& instr_opts)
 {
-    auto &the_module = *detail::llvm_ir_emitter{a.name, ctx, sctx}.emit(a.root);
+    auto &the_module = *detail::llvm_ir_emitter{a.name, ctx, sctx, gc_opts, debug_opts, instr_opts}.emit(a.root);
     std::string errmsg;
 
 #if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
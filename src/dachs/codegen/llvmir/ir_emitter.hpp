@@ -7,12 +7,22 @@
 #include "dachs/semantics/scope_fwd.hpp"
 #include "dachs/semantics/semantics_context.hpp"
 #include "dachs/codegen/llvmir/context.hpp"
+#include "dachs/codegen/gc_options.hpp"
+#include "dachs/codegen/debug_options.hpp"
+#include "dachs/codegen/instrumentation_options.hpp"
 
 namespace dachs {
 namespace codegen {
 namespace llvmir {
 
-llvm::Module &emit_llvm_ir(ast::ast const& a, semantics::semantics_context const& t, context &ctx);
+llvm::Module &emit_llvm_ir(
+        ast::ast const& a,
+        semantics::semantics_context const& t,
+        context &ctx,
+        gc_options const& gc_opts = {},
+        debug_options const& debug_opts = {},
+        instrumentation_options const& instr_opts = {}
+    );
 
 } // namespace llvm
 } // namespace codegen
@@ -0,0 +1,233 @@
+#if !defined DACHS_CODEGEN_LLVMIR_MODULE_SPLITTER_HPP_INCLUDED
+#define      DACHS_CODEGEN_LLVMIR_MODULE_SPLITTER_HPP_INCLUDED
+
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalValue.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/Bitcode/ReaderWriter.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dachs/exception.hpp"
+
+namespace dachs {
+namespace codegen {
+namespace llvmir {
+namespace detail {
+
+// Note:
+// Split an optimized module into partitions for parallel code generation.
+// Each function definition is owned by one partition.  Global variables are
+// owned by the first partition.  Symbols with local linkage are referred
+// from other partitions, so they are made external with hidden visibility and
+// renamed not to conflict with symbols of other modules.
+// Partitions are extracted into their own LLVMContext because a context must
+// not be used by multiple threads.  The module is serialized as bitcode once
+// and each partition is read from it.
+class module_splitter {
+    llvm::Module &module;
+    std::size_t num_partitions;
+    std::unordered_map<std::string, std::size_t> owners;
+    std::string bitcode;
+
+    static bool is_splittable(llvm::Module const& m)
+    {
+        // Note:
+        // An alias can't be a declaration, so it is never split.
+        return m.alias_empty();
+    }
+
+    static std::size_t count_insts(llvm::Function const& f)
+    {
+        std::size_t n = 0u;
+        for (auto const& block : f) {
+            n += block.size();
+        }
+        return n;
+    }
+
+    static void externalize(llvm::GlobalValue &g, std::string const& suffix)
+    {
+        if (g.getName().startswith("llvm.")) {
+            return;
+        }
+
+        if (g.hasLocalLinkage()) {
+            g.setName((g.hasName() ? g.getName().str() : std::string{"dachs.anon"}) + suffix);
+            g.setLinkage(llvm::GlobalValue::ExternalLinkage);
+            g.setVisibility(llvm::GlobalValue::HiddenVisibility);
+        } else if (g.hasLinkOnceLinkage()) {
+            // Note:
+            // Unreferenced linkonce definitions are dropped by code generation,
+            // even if they are referred from other partitions.
+            g.setLinkage(g.hasLinkOnceODRLinkage() ? llvm::GlobalValue::WeakODRLinkage : llvm::GlobalValue::WeakAnyLinkage);
+        }
+    }
+
+    void externalize_local_symbols()
+    {
+        auto const suffix = (boost::format(".dachs.%1$x") % std::hash<std::string>{}(module.getModuleIdentifier())).str();
+
+        for (auto &f : module) {
+            if (!f.isDeclaration()) {
+                externalize(f, suffix);
+            }
+        }
+
+        for (auto g = module.global_begin(); g != module.global_end(); ++g) {
+            if (!g->isDeclaration()) {
+                externalize(*g, suffix);
+            }
+        }
+    }
+
+    // Note:
+    // Larger functions are assigned first to the partition with the fewest
+    // instructions so that each thread has a similar amount of work.
+    std::vector<std::pair<llvm::Function const*, std::size_t>> assign_partitions()
+    {
+        std::vector<std::pair<std::size_t, llvm::Function const*>> funcs;
+        for (auto const& f : module) {
+            if (!f.isDeclaration() && !f.hasAvailableExternallyLinkage()) {
+                funcs.emplace_back(count_insts(f), &f);
+            }
+        }
+
+        std::stable_sort(
+                std::begin(funcs),
+                std::end(funcs),
+                [](auto const& l, auto const& r){ return l.first > r.first; }
+            );
+
+        num_partitions = std::min(num_partitions, funcs.size());
+        if (num_partitions <= 1u) {
+            num_partitions = 1u;
+            return {};
+        }
+
+        std::vector<std::pair<llvm::Function const*, std::size_t>> assignments;
+        std::vector<std::size_t> loads(num_partitions, 0u);
+        for (auto const& f : funcs) {
+            auto const lightest = std::min_element(std::begin(loads), std::end(loads));
+            assignments.emplace_back(f.second, static_cast<std::size_t>(lightest - std::begin(loads)));
+            *lightest += f.first + 1u;
+        }
+
+        return assignments;
+    }
+
+    std::unique_ptr<llvm::Module> parse(llvm::LLVMContext &c) const
+    {
+        std::unique_ptr<llvm::MemoryBuffer> buffer{llvm::MemoryBuffer::getMemBuffer(bitcode, module.getModuleIdentifier(), false)};
+
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
+        std::string error;
+        std::unique_ptr<llvm::Module> parsed{llvm::ParseBitcodeFile(buffer.get(), c, &error)};
+        if (!parsed) {
+            throw code_generation_error{"LLVM IR generator", boost::format("Failed to split module '%1%': %2%") % module.getModuleIdentifier() % error};
+        }
+        return parsed;
+#elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
+        auto parsed = llvm::parseBitcodeFile(buffer.get(), c);
+        if (!parsed) {
+            throw code_generation_error{"LLVM IR generator", boost::format("Failed to split module '%1%': %2%") % module.getModuleIdentifier() % parsed.getError().message()};
+        }
+        return std::unique_ptr<llvm::Module>{parsed.get()};
+#else
+# error LLVM: Not supported version.
+#endif
+    }
+
+public:
+
+    module_splitter(llvm::Module &m, std::size_t const n)
+        : module(m), num_partitions(is_splittable(m) ? n : 1u), owners(), bitcode()
+    {
+        auto const assignments = assign_partitions();
+        if (num_partitions <= 1u) {
+            return;
+        }
+
+        // Note: Owners are looked up by name after local symbols are renamed.
+        externalize_local_symbols();
+        for (auto const& a : assignments) {
+            owners.emplace(a.first->getName().str(), a.second);
+        }
+
+        llvm::raw_string_ostream os{bitcode};
+        llvm::WriteBitcodeToFile(&module, os);
+        os.flush();
+    }
+
+    // Note:
+    // 1 means the module is not split and should be compiled as it is.
+    std::size_t size() const noexcept
+    {
+        return num_partitions;
+    }
+
+    // Note:
+    // May be called from multiple threads with different contexts.
+    std::unique_ptr<llvm::Module> extract(std::size_t const partition, llvm::LLVMContext &c) const
+    {
+        assert(partition < num_partitions);
+
+        auto m = parse(c);
+
+        for (auto &f : *m) {
+            if (f.isDeclaration()) {
+                continue;
+            }
+
+            auto const owner = owners.find(f.getName().str());
+            if (owner != std::end(owners) && owner->second != partition) {
+                f.deleteBody();
+            }
+        }
+
+        if (partition != 0u) {
+            std::vector<llvm::GlobalVariable *> erased;
+            for (auto g = m->global_begin(); g != m->global_end(); ++g) {
+                if (g->isDeclaration()) {
+                    continue;
+                }
+
+                if (g->hasAppendingLinkage()) {
+                    // Note: e.g. llvm.global_ctors
+                    erased.push_back(&*g);
+                } else {
+                    g->setInitializer(nullptr);
+                    g->setLinkage(llvm::GlobalValue::ExternalLinkage);
+                }
+            }
+
+            for (auto *const g : erased) {
+                g->eraseFromParent();
+            }
+        }
+
+        return m;
+    }
+};
+
+} // namespace detail
+} // namespace llvmir
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_LLVMIR_MODULE_SPLITTER_HPP_INCLUDED
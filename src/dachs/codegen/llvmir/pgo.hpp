@@ -0,0 +1,284 @@
+#if !defined DACHS_CODEGEN_LLVMIR_PGO_HPP_INCLUDED
+#define      DACHS_CODEGEN_LLVMIR_PGO_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+
+#include "dachs/codegen/llvmir/context.hpp"
+#include "dachs/pgo_profile.hpp"
+
+namespace dachs {
+namespace codegen {
+namespace llvmir {
+namespace detail {
+
+// Note:
+// Layout of the counters of a function.  The instrumented IR and the IR to
+// be annotated must be the same IR before optimization, so the layout is
+// computed from the IR in the same way for both.
+//   0          : Function entries
+//   br i1      : 2 counters for 'true' and 'false' edges
+//   switch     : 1 counter for all executions followed by 1 counter per case.
+//                Executions of the default case are the rest of them.
+// 'f' is called with each branch and the index of its first counter.
+// The number of counters is returned.
+template<class F>
+std::size_t walk_pgo_counters(llvm::Function &func, F const& f)
+{
+    std::size_t idx = 1u;
+    for (auto &block : func) {
+        auto *const term = block.getTerminator();
+        if (auto *const br = llvm::dyn_cast_or_null<llvm::BranchInst>(term)) {
+            if (br->isConditional()) {
+                f(br, idx);
+                idx += 2u;
+            }
+        } else if (auto *const sw = llvm::dyn_cast_or_null<llvm::SwitchInst>(term)) {
+            f(sw, idx);
+            idx += 1u + sw->getNumCases();
+        }
+    }
+    return idx;
+}
+
+// Note:
+// Checksum of the control flow of a function.  The opcode and the number of
+// successors of the terminator of each block are hashed in order (FNV-1a).
+// It is stored in the profile with the counters, so a function changed after
+// the profile was generated is detected even if its number of counters is
+// the same.  Instrumentation adds no block, so the checksum is the same before
+// and after it.
+inline std::uint64_t pgo_checksum(llvm::Function const& func)
+{
+    std::uint64_t hash = 14695981039346656037u;
+    auto const mix
+        = [&hash](std::uint64_t const v)
+        {
+            hash ^= v;
+            hash *= 1099511628211u;
+        };
+
+    for (auto const& block : func) {
+        if (auto const* const term = block.getTerminator()) {
+            mix(term->getOpcode());
+            mix(term->getNumSuccessors());
+        }
+    }
+
+    return hash;
+}
+
+inline bool is_pgo_target(llvm::Function const& func)
+{
+    return !func.isDeclaration() && !func.getName().startswith("dachs.pgo.");
+}
+
+// Note:
+// Insert counters for --profile-generate.  Counters of each function are an
+// array in a global variable.  A module constructor registers them to the
+// runtime, which writes them to the profile at exit.
+class pgo_instrumenter {
+    context &ctx;
+    llvm::Module &module;
+    std::string const& file;
+    llvm::IRBuilder<> builder;
+
+    void emit_increment(llvm::GlobalVariable *const counters, std::size_t const idx, llvm::Value *const amount)
+    {
+        auto *const ptr = builder.CreateConstInBoundsGEP2_64(counters, 0u, idx);
+        builder.CreateStore(builder.CreateAdd(builder.CreateLoad(ptr), amount), ptr);
+    }
+
+    void instrument(llvm::BranchInst *const br, llvm::GlobalVariable *const counters, std::size_t const idx)
+    {
+        builder.SetInsertPoint(br);
+        auto *const cond = br->getCondition();
+        emit_increment(counters, idx, builder.CreateZExt(cond, builder.getInt64Ty()));
+        emit_increment(counters, idx + 1u, builder.CreateZExt(builder.CreateNot(cond), builder.getInt64Ty()));
+    }
+
+    void instrument(llvm::SwitchInst *const sw, llvm::GlobalVariable *const counters, std::size_t idx)
+    {
+        builder.SetInsertPoint(sw);
+        auto *const cond = sw->getCondition();
+        emit_increment(counters, idx, builder.getInt64(1u));
+        for (auto c = sw->case_begin(); c != sw->case_end(); ++c) {
+            emit_increment(counters, ++idx, builder.CreateZExt(builder.CreateICmpEQ(cond, c.getCaseValue()), builder.getInt64Ty()));
+        }
+    }
+
+    llvm::GlobalVariable *instrument(llvm::Function &func)
+    {
+        auto const size = walk_pgo_counters(func, [](auto const, auto const){});
+        auto *const counters_ty = llvm::ArrayType::get(builder.getInt64Ty(), size);
+        auto *const counters = new llvm::GlobalVariable(
+                module,
+                counters_ty,
+                false /*constant*/,
+                llvm::GlobalValue::PrivateLinkage,
+                llvm::ConstantAggregateZero::get(counters_ty),
+                "dachs.pgo.counters"
+            );
+
+        auto &entry = func.getEntryBlock();
+        builder.SetInsertPoint(&entry, entry.getFirstInsertionPt());
+        emit_increment(counters, 0u, builder.getInt64(1u));
+
+        walk_pgo_counters(func, [&](auto *const inst, auto const idx){ this->instrument(inst, counters, idx); });
+
+        return counters;
+    }
+
+public:
+
+    pgo_instrumenter(context &c, llvm::Module &m, std::string const& f)
+        : ctx(c), module(m), file(f), builder(c.llvm_context)
+    {}
+
+    void instrument()
+    {
+        std::vector<std::tuple<std::string, std::uint64_t, std::size_t, llvm::GlobalVariable *>> registered;
+        for (auto &f : module) {
+            if (is_pgo_target(f)) {
+                auto const checksum = pgo_checksum(f);
+                auto *const counters = instrument(f);
+                registered.emplace_back(f.getName().str(), checksum, counters->getType()->getElementType()->getArrayNumElements(), counters);
+            }
+        }
+
+        auto *const register_func = llvm::cast<llvm::Function>(
+                module.getOrInsertFunction(
+                    "__dachs_pgo_register__",
+                    builder.getVoidTy(),
+                    builder.getInt8PtrTy(),
+                    builder.getInt8PtrTy(),
+                    builder.getInt64Ty(),
+                    builder.getInt64Ty(),
+                    builder.getInt64Ty()->getPointerTo(),
+                    nullptr
+                )
+            );
+
+        auto *const ctor = llvm::Function::Create(
+                llvm::FunctionType::get(builder.getVoidTy(), false),
+                llvm::Function::InternalLinkage,
+                "dachs.pgo.init",
+                &module
+            );
+        builder.SetInsertPoint(llvm::BasicBlock::Create(ctx.llvm_context, "entry", ctor));
+
+        auto *const file_value = builder.CreateGlobalStringPtr(file, "dachs.pgo.file");
+        for (auto const& r : registered) {
+            builder.CreateCall5(
+                    register_func,
+                    file_value,
+                    builder.CreateGlobalStringPtr(std::get<0>(r), "dachs.pgo.name"),
+                    builder.getInt64(std::get<1>(r)),
+                    builder.getInt64(std::get<2>(r)),
+                    builder.CreateConstInBoundsGEP2_64(std::get<3>(r), 0u, 0u)
+                );
+        }
+        builder.CreateRetVoid();
+
+        llvm::appendToGlobalCtors(module, ctor, 0);
+    }
+};
+
+// Note:
+// Attach the counts in the profile to the IR for --profile-use.
+// Conditional branches and switches get branch weights, which are used by
+// the block placement and other passes.  Functions which were never called
+// are marked as cold and not hinted to be inlined.  Functions whose checksum
+// or number of counters doesn't match the profile were changed after the
+// profile was generated, so they are not annotated.
+class pgo_annotator {
+    runtime::pgo_profile const& profile;
+
+    static std::vector<std::uint32_t> to_weights(std::vector<std::uint64_t> const& counts)
+    {
+        auto const max = *std::max_element(std::begin(counts), std::end(counts));
+        auto const scale = max / std::numeric_limits<std::uint32_t>::max() + 1u;
+
+        std::vector<std::uint32_t> weights;
+        for (auto const c : counts) {
+            // Note: Zero weight is treated as unknown by some passes
+            weights.push_back(static_cast<std::uint32_t>(std::max<std::uint64_t>(c / scale, 1u)));
+        }
+        return weights;
+    }
+
+    static void annotate(llvm::BranchInst *const br, std::vector<std::uint64_t> const& counts, std::size_t const idx)
+    {
+        llvm::MDBuilder md{br->getContext()};
+        br->setMetadata(llvm::LLVMContext::MD_prof, md.createBranchWeights(to_weights({counts[idx], counts[idx + 1u]})));
+    }
+
+    static void annotate(llvm::SwitchInst *const sw, std::vector<std::uint64_t> const& counts, std::size_t const idx)
+    {
+        auto const total = counts[idx];
+        std::vector<std::uint64_t> case_counts = {0u};
+        for (auto i = 0u; i < sw->getNumCases(); ++i) {
+            case_counts.push_back(counts[idx + 1u + i]);
+        }
+
+        auto const sum = std::accumulate(std::next(std::begin(case_counts)), std::end(case_counts), std::uint64_t{0u});
+        case_counts[0] = total >= sum ? total - sum : 0u;
+
+        llvm::MDBuilder md{sw->getContext()};
+        sw->setMetadata(llvm::LLVMContext::MD_prof, md.createBranchWeights(to_weights(case_counts)));
+    }
+
+public:
+
+    explicit pgo_annotator(runtime::pgo_profile const& p) noexcept
+        : profile(p)
+    {}
+
+    void annotate(llvm::Module &module) const
+    {
+        for (auto &f : module) {
+            if (!is_pgo_target(f)) {
+                continue;
+            }
+
+            auto const itr = profile.functions.find(f.getName().str());
+            if (itr == std::end(profile.functions)) {
+                continue;
+            }
+
+            if (!itr->second.matches(pgo_checksum(f), walk_pgo_counters(f, [](auto const, auto const){}))) {
+                continue;
+            }
+
+            auto const& counts = itr->second.counts;
+
+            walk_pgo_counters(f, [&counts](auto *const inst, auto const idx){ pgo_annotator::annotate(inst, counts, idx); });
+
+            if (counts[0] == 0u) {
+                f.removeFnAttr(llvm::Attribute::InlineHint);
+                f.addFnAttr(llvm::Attribute::Cold);
+            }
+        }
+    }
+};
+
+} // namespace detail
+} // namespace llvmir
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_LLVMIR_PGO_HPP_INCLUDED
@@ -39,8 +39,8 @@ public:
 
     val emit(type::builtin_type const& builtin)
     {
-        bool const is_float = builtin->name == "float";
-        bool const is_int = builtin->name == "int" || builtin->name == "bool" || builtin->name == "char";
+        bool const is_float = builtin->is_floating_point();
+        bool const is_int = builtin->is_integer() || builtin->name == "bool" || builtin->name == "char";
 
         if (op == "+") {
             // Note: Do nothing.
@@ -104,12 +104,15 @@ public:
 
     val emit(type::builtin_type const& builtin) noexcept
     {
-        bool const is_float = builtin->name == "float";
-        bool const is_int = builtin->name == "int" || builtin->name == "bool" || builtin->name == "char";
-        bool const is_uint = builtin->name == "uint";
+        bool const is_float = builtin->is_floating_point();
+        bool const is_int = builtin->is_signed_integer() || builtin->name == "bool" || builtin->name == "char";
+        bool const is_uint = builtin->is_unsigned_integer();
         bool const is_symbol = builtin->name == "symbol";
 
         if (op == ">>") {
+            if (is_uint) {
+                return ctx.builder.CreateLShr(lhs, rhs, "lshrtmp");
+            }
             return ctx.builder.CreateAShr(lhs, rhs, "shrtmp");
         } else if (op == "<<") {
             return ctx.builder.CreateShl(lhs, rhs, "shltmp");
@@ -58,6 +58,14 @@ public:
             result = llvm::Type::getInt1Ty(context);
         } else if (builtin->name == "symbol") {
             result = llvm::Type::getInt64Ty(context);
+        } else if (builtin->name == "i8" || builtin->name == "u8") {
+            result = llvm::Type::getInt8Ty(context);
+        } else if (builtin->name == "i16") {
+            result = llvm::Type::getInt16Ty(context);
+        } else if (builtin->name == "i32" || builtin->name == "u32") {
+            result = llvm::Type::getInt32Ty(context);
+        } else if (builtin->name == "f32") {
+            result = llvm::Type::getFloatTy(context);
         } else {
             DACHS_RAISE_INTERNAL_COMPILATION_ERROR
         }
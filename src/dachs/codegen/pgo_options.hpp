@@ -0,0 +1,23 @@
+#if !defined DACHS_CODEGEN_PGO_OPTIONS_HPP_INCLUDED
+#define      DACHS_CODEGEN_PGO_OPTIONS_HPP_INCLUDED
+
+#include <string>
+
+namespace dachs {
+namespace codegen {
+
+// Note:
+// Instrumentation-based profile guided optimization.
+// When 'generate_file' is not empty, executables count function entries and
+// branches, and merge the counts into the file at exit.
+// When 'use_file' is not empty, the counts in the file are attached to the IR
+// as branch weights and cold function attributes before optimization.
+struct pgo_options {
+    std::string generate_file;
+    std::string use_file;
+};
+
+} // namespace codegen
+} // namespace dachs
+
+#endif    // DACHS_CODEGEN_PGO_OPTIONS_HPP_INCLUDED
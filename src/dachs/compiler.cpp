@@ -22,8 +22,8 @@
 
 namespace dachs {
 
-compiler::compiler(bool const colorful, bool const d, codegen::opt_level const o)
-    : debug(d), opt(o)
+compiler::compiler(bool const colorful, bool const d, compile_options const& o)
+    : debug(d), options(o)
 {
     helper::colorizer::enabled = colorful;
 }
@@ -41,6 +41,8 @@ std::string compiler::compile(compiler::files_type const& files, std::vector<std
 {
     std::vector<llvm::Module *> modules;
     codegen::llvmir::context context;
+    helper::time_report report{options.time_report};
+    helper::compile_stats stats{options.stats};
 
     for (auto const& f : files) {
         auto const code = read(f);
@@ -48,20 +50,26 @@ std::string compiler::compile(compiler::files_type const& files, std::vector<std
             std::cerr << "file: " << f << '\n';
         }
 
-        auto ast = parser.parse(code, f);
+        report.set_file(f);
+        auto ast = report.measure("parse", [&]{ return parser.parse(code, f); });
         if (debug) {
             std::cerr << ast::stringize_ast(ast) << "\n\n";
         }
 
         syntax::importer importer{importdirs, f};
-        auto ctx = semantics::analyze_semantics(ast, importer);
+        importer.report = &report;
+        auto ctx = semantics::analyze_semantics(ast, importer, report);
+        stats.add_instantiations(ctx.template_instantiations);
         if (debug) {
             std::cerr << "=========Scope Tree=========\n\n"
                       <<  scope::stringize_scope_tree(ctx.scopes) << "\n\n";
 
         }
 
-        auto &module = codegen::llvmir::emit_llvm_ir(ast, ctx, context);
+        auto &module = report.measure(
+                "IR emission",
+                [&]() -> llvm::Module & { return codegen::llvmir::emit_llvm_ir(ast, ctx, context, options.gc, options.debug_info, options.instrumentation); }
+            );
         if (debug) {
             std::cerr << "=========LLVM IR=========\n\n";
             module.dump();
@@ -70,20 +78,31 @@ std::string compiler::compile(compiler::files_type const& files, std::vector<std
         modules.push_back(&module);
     }
 
-    return codegen::llvmir::generate_executable(modules, libdirs, context, opt, std::move(parent));
+    auto executable = codegen::llvmir::generate_executable(modules, libdirs, context, report, stats, options.opt, options.pgo, options.codegen_threads, std::move(parent));
+    report.print(std::cerr);
+    stats.print(std::cerr);
+    return executable;
 }
 
 std::vector<std::string> compiler::compile_to_objects(compiler::files_type const& files, files_type const& importdirs, std::string parent) const
 {
     std::vector<llvm::Module *> modules;
     codegen::llvmir::context context;
+    helper::time_report report{options.time_report};
+    helper::compile_stats stats{options.stats};
 
     for (auto const& f : files) {
         auto const code = read(f);
-        auto ast = parser.parse(code, f);
+        report.set_file(f);
+        auto ast = report.measure("parse", [&]{ return parser.parse(code, f); });
         syntax::importer importer{importdirs, f};
-        auto semantics = semantics::analyze_semantics(ast, importer);
-        auto &module = codegen::llvmir::emit_llvm_ir(ast, semantics, context);
+        importer.report = &report;
+        auto semantics = semantics::analyze_semantics(ast, importer, report);
+        stats.add_instantiations(semantics.template_instantiations);
+        auto &module = report.measure(
+                "IR emission",
+                [&]() -> llvm::Module & { return codegen::llvmir::emit_llvm_ir(ast, semantics, context, options.gc, options.debug_info, options.instrumentation); }
+            );
         if (debug) {
             std::cerr << "file: " << f << '\n'
                       << ast::stringize_ast(ast)
@@ -95,7 +114,10 @@ std::vector<std::string> compiler::compile_to_objects(compiler::files_type const
         modules.push_back(&module);
     }
 
-    return codegen::llvmir::generate_objects(modules, context, opt, parent);
+    auto objects = codegen::llvmir::generate_objects(modules, context, report, stats, options.opt, options.pgo, options.codegen_threads, parent);
+    report.print(std::cerr);
+    stats.print(std::cerr);
+    return objects;
 }
 
 std::string compiler::report_ast(std::string const& file, std::string const& code) const
@@ -121,7 +143,7 @@ std::string compiler::report_llvm_ir(std::string const& file, std::string const&
     llvm::raw_string_ostream raw_os{result};
 
     codegen::llvmir::context context;
-    codegen::llvmir::emit_llvm_ir(ast, ctx, context).print(raw_os, nullptr);
+    codegen::llvmir::emit_llvm_ir(ast, ctx, context, options.gc, options.debug_info, options.instrumentation).print(raw_os, nullptr);
     return result;
 }
 
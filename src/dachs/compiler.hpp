@@ -1,6 +1,7 @@
 #if !defined DACHS_COMPILER_HPP_INCLUDED
 #define      DACHS_COMPILER_HPP_INCLUDED
 
+#include <cstddef>
 #include <string>
 #include <iostream>
 
@@ -8,13 +9,33 @@
 #include "dachs/parser/parser.hpp"
 #include "dachs/semantics/scope.hpp"
 #include "dachs/codegen/opt_level.hpp"
+#include "dachs/codegen/gc_options.hpp"
+#include "dachs/codegen/debug_options.hpp"
+#include "dachs/codegen/instrumentation_options.hpp"
+#include "dachs/codegen/pgo_options.hpp"
+#include "dachs/helper/time_report.hpp"
+#include "dachs/helper/compile_stats.hpp"
 
 namespace dachs {
 
+// Note:
+// Options of code generation and reports of a compilation.  They are given by
+// command line options.
+struct compile_options {
+    codegen::opt_level opt = codegen::opt_level::none;
+    codegen::gc_options gc;
+    codegen::debug_options debug_info;
+    codegen::instrumentation_options instrumentation;
+    codegen::pgo_options pgo;
+    helper::time_report::format time_report = helper::time_report::format::none;
+    bool stats = false;
+    std::size_t codegen_threads = 1u;
+};
+
 class compiler final {
     syntax::parser parser;
     bool debug;
-    codegen::opt_level opt;
+    compile_options options;
 
     using files_type = std::vector<std::string>;
 
@@ -22,7 +43,11 @@ class compiler final {
 
 public:
 
-    compiler(bool const colorful, bool const debug, codegen::opt_level const opt = codegen::opt_level::none);
+    compiler(
+            bool const colorful,
+            bool const debug,
+            compile_options const& options = {}
+        );
 
     std::string compile(
             files_type const& files,
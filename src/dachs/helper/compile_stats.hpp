@@ -0,0 +1,171 @@
+#if !defined DACHS_HELPER_COMPILE_STATS_HPP_INCLUDED
+#define      DACHS_HELPER_COMPILE_STATS_HPP_INCLUDED
+
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+
+#include <boost/format.hpp>
+
+namespace dachs {
+namespace helper {
+
+// Note:
+// Statistics of code size for --stats.  Templates are listed with the types
+// which instantiated them, and functions are listed with the number of IR
+// instructions before and after optimization.  They show which generic calls
+// bloat executables.  When the stats are disabled, record functions do nothing.
+class compile_stats {
+public:
+
+    // Note: Template name -> types of each instantiation
+    using instantiations_type = std::map<std::string, std::vector<std::string>>;
+
+    struct func_size {
+        std::string file;
+        std::string name;
+        std::size_t before_opt = 0u;
+        std::size_t after_opt = 0u;
+    };
+
+private:
+
+    bool is_enabled;
+    instantiations_type instantiations;
+    std::map<std::pair<std::string, std::string>, func_size> func_sizes;
+
+    func_size &get_func_size(std::string const& file, std::string const& name)
+    {
+        auto &s = func_sizes[std::make_pair(file, name)];
+        s.file = file;
+        s.name = name;
+        return s;
+    }
+
+public:
+
+    explicit compile_stats(bool const e = false) noexcept
+        : is_enabled(e)
+    {}
+
+    bool enabled() const noexcept
+    {
+        return is_enabled;
+    }
+
+    void add_instantiations(instantiations_type const& is)
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        for (auto const& i : is) {
+            auto &types = instantiations[i.first];
+            types.insert(std::end(types), std::begin(i.second), std::end(i.second));
+        }
+    }
+
+    void record_size_before_opt(std::string const& file, std::string const& func, std::size_t const num_insts)
+    {
+        if (enabled()) {
+            get_func_size(file, func).before_opt = num_insts;
+        }
+    }
+
+    void record_size_after_opt(std::string const& file, std::string const& func, std::size_t const num_insts)
+    {
+        if (enabled()) {
+            get_func_size(file, func).after_opt = num_insts;
+        }
+    }
+
+    instantiations_type const& get_instantiations() const noexcept
+    {
+        return instantiations;
+    }
+
+    // Note:
+    // Sorted by the size after optimization because it is the size in the
+    // executable.  Functions removed by optimization (e.g. inlined) are last.
+    std::vector<func_size> get_func_sizes() const
+    {
+        std::vector<func_size> result;
+        result.reserve(func_sizes.size());
+        for (auto const& s : func_sizes) {
+            result.push_back(s.second);
+        }
+
+        std::stable_sort(
+                std::begin(result),
+                std::end(result),
+                [](auto const& l, auto const& r)
+                {
+                    if (l.after_opt != r.after_opt) {
+                        return l.after_opt > r.after_opt;
+                    }
+                    return l.before_opt > r.before_opt;
+                }
+            );
+
+        return result;
+    }
+
+    void print(std::ostream &out, std::size_t const max_funcs = 30u) const
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        std::vector<std::pair<std::string, std::vector<std::string>>> templates{std::begin(instantiations), std::end(instantiations)};
+        std::stable_sort(
+                std::begin(templates),
+                std::end(templates),
+                [](auto const& l, auto const& r){ return l.second.size() > r.second.size(); }
+            );
+
+        std::size_t total_instantiations = 0u;
+        for (auto const& t : templates) {
+            total_instantiations += t.second.size();
+        }
+
+        out << "===------------------------- Dachs compile stats -------------------------===\n"
+            << boost::format("Template instantiations: %1% of %2% templates\n") % total_instantiations % templates.size();
+        for (auto const& t : templates) {
+            out << boost::format("%8d  %s\n") % t.second.size() % t.first;
+            for (auto const& types : t.second) {
+                out << "            (" << types << ")\n";
+            }
+        }
+
+        auto const sizes = get_func_sizes();
+        std::size_t total_before = 0u, total_after = 0u;
+        for (auto const& s : sizes) {
+            total_before += s.before_opt;
+            total_after += s.after_opt;
+        }
+
+        out << boost::format("\nIR instructions: %1% before optimization, %2% after optimization in %3% functions\n") % total_before % total_after % sizes.size()
+            << boost::format("%12s %12s  %s\n") % "before opt" % "after opt" % "function";
+        for (auto const& s : sizes) {
+            if (static_cast<std::size_t>(&s - sizes.data()) >= max_funcs) {
+                out << boost::format("  ... and %1% more functions\n") % (sizes.size() - max_funcs);
+                break;
+            }
+            out << boost::format("%12d %12s  %s (%s)\n")
+                    % s.before_opt
+                    % (s.after_opt == 0u ? std::string{"-"} : std::to_string(s.after_opt))
+                    % s.name
+                    % s.file;
+        }
+    }
+};
+
+} // namespace helper
+} // namespace dachs
+
+#endif    // DACHS_HELPER_COMPILE_STATS_HPP_INCLUDED
@@ -0,0 +1,242 @@
+#if !defined DACHS_HELPER_TIME_REPORT_HPP_INCLUDED
+#define      DACHS_HELPER_TIME_REPORT_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <boost/format.hpp>
+
+namespace dachs {
+namespace helper {
+
+// Note:
+// Wall time, CPU time and peak RSS of each compilation phase for --time-report.
+// Phases can be nested.  A nested phase is measured while its parent is running
+// and is shown indented under the parent.  Peak RSS is the maximum resident set
+// size of the compiler process observed at the end of the phase.
+// When the report is disabled, measure() only calls the given function.
+class time_report {
+public:
+
+    enum class format {
+        none,
+        table,
+        json,
+    };
+
+    struct entry {
+        std::string file;
+        std::string phase;
+        unsigned depth;
+        double wall_sec;
+        double cpu_sec;
+        long peak_rss_kb;
+    };
+
+private:
+
+    using clock = std::chrono::steady_clock;
+
+    format fmt;
+    std::vector<entry> entries;
+    std::string current_file;
+    unsigned depth = 0u;
+
+    static double cpu_sec() noexcept
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+            + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    static long peak_rss_kb() noexcept
+    {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        // Note: ru_maxrss is in bytes on OS X
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+
+    static std::string escape_json(std::string const& s)
+    {
+        std::string escaped;
+        for (auto const c : s) {
+            switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20u) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    escaped += buf;
+                } else {
+                    escaped += c;
+                }
+                break;
+            }
+        }
+        return escaped;
+    }
+
+public:
+
+    class phase_guard {
+        time_report *report;
+        std::size_t index;
+        clock::time_point wall_start;
+        double cpu_start;
+
+    public:
+
+        phase_guard(time_report *const r, std::size_t const i) noexcept
+            : report(r), index(i), wall_start(clock::now()), cpu_start(r ? cpu_sec() : 0.0)
+        {}
+
+        phase_guard(phase_guard &&rhs) noexcept
+            : report(rhs.report), index(rhs.index), wall_start(rhs.wall_start), cpu_start(rhs.cpu_start)
+        {
+            rhs.report = nullptr;
+        }
+
+        phase_guard(phase_guard const&) = delete;
+        phase_guard &operator=(phase_guard const&) = delete;
+
+        ~phase_guard()
+        {
+            if (!report) {
+                return;
+            }
+
+            auto &e = report->entries[index];
+            e.wall_sec = std::chrono::duration<double>(clock::now() - wall_start).count();
+            e.cpu_sec = cpu_sec() - cpu_start;
+            e.peak_rss_kb = peak_rss_kb();
+            --report->depth;
+        }
+    };
+
+    explicit time_report(format const f = format::none) noexcept
+        : fmt(f)
+    {}
+
+    bool enabled() const noexcept
+    {
+        return fmt != format::none;
+    }
+
+    // Note:
+    // Phases started after this call are recorded for 'file'.
+    // Phases not related to a specific file (e.g. link) use an empty name.
+    void set_file(std::string const& file)
+    {
+        current_file = file;
+    }
+
+    phase_guard start(std::string const& phase)
+    {
+        if (!enabled()) {
+            return {nullptr, 0u};
+        }
+
+        entries.push_back({current_file, phase, depth, 0.0, 0.0, 0});
+        ++depth;
+        return {this, entries.size() - 1u};
+    }
+
+    template<class F>
+    decltype(auto) measure(std::string const& phase, F &&f)
+    {
+        auto const guard = start(phase);
+        return f();
+    }
+
+    std::vector<entry> const& get_entries() const noexcept
+    {
+        return entries;
+    }
+
+    void print_table(std::ostream &out) const
+    {
+        out << "===------------------------- Dachs time report -------------------------===\n"
+            << boost::format("%-40s %10s %10s %14s\n") % "Phase" % "Wall (s)" % "CPU (s)" % "Peak RSS (KB)";
+
+        std::string file;
+        double total_wall = 0.0, total_cpu = 0.0;
+        long total_rss = 0;
+        for (auto const& e : entries) {
+            if (e.file != file || &e == &entries.front()) {
+                file = e.file;
+                out << (file.empty() ? std::string{"(all files)"} : file) << '\n';
+            }
+
+            out << boost::format("%-40s %10.4f %10.4f %14d\n")
+                    % (std::string(2u + e.depth * 2u, ' ') + e.phase)
+                    % e.wall_sec
+                    % e.cpu_sec
+                    % e.peak_rss_kb;
+
+            if (e.depth == 0u) {
+                total_wall += e.wall_sec;
+                total_cpu += e.cpu_sec;
+            }
+            if (e.peak_rss_kb > total_rss) {
+                total_rss = e.peak_rss_kb;
+            }
+        }
+
+        out << boost::format("%-40s %10.4f %10.4f %14d\n") % "Total" % total_wall % total_cpu % total_rss;
+    }
+
+    void print_json(std::ostream &out) const
+    {
+        out << "{\"phases\":[";
+        for (auto const& e : entries) {
+            if (&e != &entries.front()) {
+                out << ',';
+            }
+            out << boost::format("\n  {\"file\":\"%1%\",\"phase\":\"%2%\",\"depth\":%3%,\"wall_sec\":%4$.6f,\"cpu_sec\":%5$.6f,\"peak_rss_kb\":%6%}")
+                    % escape_json(e.file)
+                    % escape_json(e.phase)
+                    % e.depth
+                    % e.wall_sec
+                    % e.cpu_sec
+                    % e.peak_rss_kb;
+        }
+        out << "\n]}\n";
+    }
+
+    void print(std::ostream &out) const
+    {
+        switch (fmt) {
+        case format::table:
+            print_table(out);
+            break;
+        case format::json:
+            print_json(out);
+            break;
+        case format::none:
+        default:
+            break;
+        }
+    }
+};
+
+} // namespace helper
+} // namespace dachs
+
+#endif    // DACHS_HELPER_TIME_REPORT_HPP_INCLUDED
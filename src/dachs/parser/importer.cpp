@@ -193,6 +193,9 @@ public:
 ast::node::inu const& importer::import(ast::node::inu const& prog)
 {
     detail::importer_impl impl{import_dirs, source, already_imported};
+    if (report) {
+        return report->measure("import", [&]() -> ast::node::inu const& { return impl.import(prog); });
+    }
     return impl.import(prog);
 }
 
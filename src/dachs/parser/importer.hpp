@@ -8,6 +8,7 @@
 #include <boost/filesystem/path.hpp>
 
 #include "dachs/ast/ast_fwd.hpp"
+#include "dachs/helper/time_report.hpp"
 
 namespace dachs {
 namespace syntax {
@@ -21,6 +22,10 @@ struct importer {
     fs::path source;
     std::set<fs::path> already_imported;
 
+    // Note:
+    // Time to parse imported files is recorded as 'import' phase if set.
+    helper::time_report *report = nullptr;
+
     template<class Source>
     importer(dirs_type const& is, Source const& s)
         : import_dirs(is), source(s), already_imported()
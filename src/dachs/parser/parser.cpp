@@ -397,8 +397,35 @@ public:
                 _val = make_node_ptr<ast::node::dict_literal>(as_vector(_1))
             ];
 
+        // Note:
+        // Literals of fixed-width types like '42i8', '255u8' and '1.5f32'.
+        // They must be tried before other numeric literals because '42u8' begins with uint literal '42u'.
+        sized_literal
+            = qi::lexeme[
+                (
+                    (qi::real_parser<double, strict_real_policies_disallowing_trailing_dot<double>>())
+                    >> "f32"_p
+                    >> !(qi::alnum | '_')
+                ) [
+                    _val = make_node_ptr<ast::node::primary_literal>(_1, _2)
+                ]
+              | (
+                    (
+                        ("0x" >> qi::hex)
+                      | ("0b" >> qi::bin)
+                      | ("0o" >> qi::oct)
+                      | qi::uint_
+                    )
+                    >> ("i8"_p | "i16"_p | "i32"_p | "u8"_p | "u32"_p)
+                    >> !(qi::alnum | '_')
+                ) [
+                    _val = make_node_ptr<ast::node::primary_literal>(_1, _2)
+                ]
+            ];
+
         primary_literal
-            = (
+            = sized_literal
+            | (
                 boolean_literal
               | character_literal
               | float_literal
@@ -1595,6 +1622,7 @@ public:
         // Rule names {{{
         inu.name("program");
         primary_literal.name("primary literal");
+        sized_literal.name("sized literal");
         string_literal.name("string literal");
         integer_literal.name("integer literal");
         uinteger_literal.name("unsigned integer literal");
@@ -1743,6 +1771,7 @@ private:
 
     rule<ast::node::any_expr()>
           primary_literal
+        , sized_literal
         , dict_literal
         , array_literal
         , lambda_expr
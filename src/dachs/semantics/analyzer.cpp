@@ -7,6 +7,7 @@
 #include <tuple>
 #include <set>
 #include <algorithm>
+#include <cstdint>
 
 #include <boost/variant/apply_visitor.hpp>
 #include <boost/variant/static_visitor.hpp>
@@ -37,6 +38,7 @@
 #include "dachs/semantics/tmp_constructor_checker.hpp"
 #include "dachs/semantics/const_func_checker.hpp"
 #include "dachs/semantics/copy_resolver.hpp"
+#include "dachs/semantics/lambda_escape_checker.hpp"
 #include "dachs/fatal.hpp"
 #include "dachs/helper/variant.hpp"
 #include "dachs/helper/util.hpp"
@@ -499,6 +501,7 @@ class symbol_analyzer {
     std::unordered_set<ast::node::function_definition> already_visited_ctors;
     boost::optional<scope::func_scope> main_arg_ctor = boost::none;
     std::unordered_map<type::class_type, scope::weak_func_scope> copiers;
+    std::map<std::string, std::vector<std::string>> template_instantiations;
 
     using class_instantiation_type_map_type = std::unordered_map<std::string, type::type>;
 
@@ -659,6 +662,10 @@ class symbol_analyzer {
         // Add instantiated function to function template node in AST
         func_template_def->instantiated.push_back(instantiated_func_def);
 
+        template_instantiations[func_template_scope->to_string()].push_back(
+                boost::algorithm::join(arg_types | transformed([](auto const& t){ return t.to_string(); }), ", ")
+            );
+
         return std::make_pair(instantiated_func_def, instantiated_func_scope);
     }
 
@@ -683,7 +690,7 @@ class symbol_analyzer {
                 arg_types
             );
 
-        if (scope->name == "__builtin_realloc") {
+        if (scope->name == "__builtin_realloc" || scope->name == "__builtin_black_box") {
             func->ret_type = func->params[0]->type;
         } else {
             assert(scope->ret_type && !scope->ret_type->is_template());
@@ -1333,9 +1340,47 @@ public:
         w();
     }
 
+    // Note:
+    // Literal with a suffix of fixed-width type like '42i8'.  The value of integer
+    // literal must be in the range of the type.  Negative values are made by unary '-'
+    // and folded into the literal by fold_negative_sized_literal().
+    void visit_sized_literal(ast::node::primary_literal const& lit)
+    {
+        auto const& suffix = lit->suffix;
+        auto const t = type::get_builtin_type(suffix.c_str());
+        if (!t) {
+            semantic_error(lit, boost::format("  Unknown literal suffix '%1%'") % suffix);
+            return;
+        }
+
+        if (auto const u = get_as<unsigned int>(lit->value)) {
+            std::uint64_t const max
+                = suffix == "i8" ? 127u
+                : suffix == "i16" ? 32767u
+                : suffix == "i32" ? 2147483647u
+                : suffix == "u8" ? 255u
+                : 4294967295u;
+
+            if (*u > max) {
+                semantic_error(
+                        lit,
+                        boost::format("  Literal %1% is out of range of type '%2%'") % *u % suffix
+                    );
+                return;
+            }
+        }
+
+        lit->type = *t;
+    }
+
     template<class Walker>
     void visit(ast::node::primary_literal const& primary_lit, Walker const& /*unused because it doesn't have child*/)
     {
+        if (!primary_lit->suffix.empty()) {
+            visit_sized_literal(primary_lit);
+            return;
+        }
+
         struct : public boost::static_visitor<char const* const> {
 
             result_type operator()(char const) const noexcept
@@ -1832,9 +1877,48 @@ public:
         }
     }
 
+    // Note:
+    // '-128i8' is parsed as unary '-' applied to '128i8', which is out of the
+    // range of i8.  The sign is folded into the literal so that the minimum
+    // value of a signed type can be written.  The unary '-' is replaced with '+'
+    // not to negate the folded value again.
+    void fold_negative_sized_literal(ast::node::unary_expr const& unary)
+    {
+        auto const lit = get_as<ast::node::primary_literal>(unary->expr);
+        if (!lit || (*lit)->suffix.empty()) {
+            return;
+        }
+
+        auto const u = get_as<unsigned int>((*lit)->value);
+        if (!u) {
+            return;
+        }
+
+        auto const& suffix = (*lit)->suffix;
+        std::uint64_t const min_abs
+            = suffix == "i8" ? 128u
+            : suffix == "i16" ? 32768u
+            : suffix == "i32" ? 2147483648u
+            : 0u;
+
+        // Note:
+        // Unsigned types and out of range values are not folded.  The latter
+        // are reported by visit_sized_literal().
+        if (min_abs == 0u || *u > min_abs) {
+            return;
+        }
+
+        (*lit)->value = static_cast<int>(-static_cast<std::int64_t>(*u));
+        unary->op = "+";
+    }
+
     template<class Walker>
     void visit(ast::node::unary_expr const& unary, Walker const& w)
     {
+        if (unary->op == "-") {
+            fold_negative_sized_literal(unary);
+        }
+
         w();
 
         auto const operand_type = type_of(unary->expr);
@@ -2374,6 +2458,21 @@ public:
             return;
         }
 
+        if (auto const from = type::get<type::builtin_type>(child_type)) {
+            if (auto const to = type::get<type::builtin_type>(cast->type)) {
+                // Note:
+                // Conversions between builtin types are allowed among numeric types and char.
+                auto const is_convertible = [](auto const& t){ return t->is_numeric() || t->name == "char"; };
+                if (*from != *to && (!is_convertible(*from) || !is_convertible(*to))) {
+                    semantic_error(cast, boost::format(
+                            "  Invalid conversion between builtin types\n"
+                            "  Note: Cast from '%1%' to '%2%'"
+                        ) % (*from)->to_string() % (*to)->to_string());
+                }
+                return;
+            }
+        }
+
         if ((!cast->type.is_aggregate() && !child_type.is_aggregate())
                 || child_type == cast->type) {
             return;
@@ -2862,6 +2961,15 @@ public:
 
         def->instantiated.push_back(copied_def);
 
+        template_instantiations["class " + def->name].push_back(
+                boost::algorithm::join(
+                    def->scope.lock()->instance_var_symbols
+                        | filtered([](auto const& s){ return s->type.is_template(); })
+                        | transformed([&map](auto const& s){ return s->name + ": " + map.at(s->name).to_string(); }),
+                    ", "
+                )
+            );
+
         auto const copied_scope = copied_def->scope.lock();
 
         substitute_class_template_params(copied_def, copied_scope, map);
@@ -3972,6 +4080,11 @@ public:
         return std::move(copiers);
     }
 
+    auto get_template_instantiations()
+    {
+        return std::move(template_instantiations);
+    }
+
     template<class Walker>
     void visit(ast::node::class_definition const& class_def, Walker const& w)
     {
@@ -4038,14 +4151,24 @@ semantics_context check_semantics(ast::ast &a, scope::scope_tree &t, syntax::imp
         throw semantic_check_error{failed, "symbol resolution"};
     }
 
+    auto captures = resolver.resolve_lambda(a.root);
+
+    // Note:
+    // Lambda receivers are fixed and lambda definitions are moved to the
+    // global scope by resolve_lambda().
+    detail::lambda_escape_checker escape_checker;
+    ast::walk_topdown(a.root, escape_checker);
+
     // Note:
     // Aggregate initialization here makes clang 3.4.2 crash.
     // I avoid it by explicitly specifying 'semantics_context'.
     return semantics_context{
         t,
-        resolver.resolve_lambda(a.root),
+        std::move(captures),
         resolver.get_main_arg_ctor(),
-        resolver.get_copiers()
+        resolver.get_copiers(),
+        escape_checker.get_stack_receivers(),
+        resolver.get_template_instantiations()
     };
 }
 
@@ -53,6 +53,17 @@ scope::scope_tree analyze_symbols_forward(ast::ast &a, syntax::importer &i)
             detail::make_global_func(scope_root, "__builtin_read_cycle_counter", type::get_builtin_type("uint"));
         }
 
+        {
+            // func monotonic_ns() : uint
+            detail::make_global_func(scope_root, "__builtin_monotonic_ns", type::get_builtin_type("uint"));
+        }
+
+        {
+            // func black_box(x)
+            auto black_box_func = detail::make_global_func(scope_root, "__builtin_black_box", dummy_template_type);
+            black_box_func->define_param(detail::make_global_func_param("value", dummy_template_type));
+        }
+
         {
             // func address_of(x)
             auto address_of_func = detail::make_global_func(scope_root, "__builtin_address_of", type::get_builtin_type("uint"));
@@ -107,6 +118,244 @@ scope::scope_tree analyze_symbols_forward(ast::ast &a, syntax::importer &i)
             detail::make_global_func(scope_root, "__builtin_disable_gc", type::get_unit_type());
             // func __builtin_gc_is_disabled()
             detail::make_global_func(scope_root, "__builtin_gc_disabled?", *type::get_builtin_type("bool"));
+            // func __builtin_gc_collect()
+            detail::make_global_func(scope_root, "__builtin_gc_collect", type::get_unit_type());
+            // func __builtin_gc_enable_incremental()
+            detail::make_global_func(scope_root, "__builtin_gc_enable_incremental", type::get_unit_type());
+            // func __builtin_gc_set_free_space_divisor(divisor : uint)
+            auto set_divisor_func = detail::make_global_func(scope_root, "__builtin_gc_set_free_space_divisor", type::get_unit_type());
+            set_divisor_func->define_param(detail::make_global_func_param("divisor", *type::get_builtin_type("uint")));
+            // func __builtin_gc_expand_heap(bytes : uint) : bool
+            auto expand_heap_func = detail::make_global_func(scope_root, "__builtin_gc_expand_heap", *type::get_builtin_type("bool"));
+            expand_heap_func->define_param(detail::make_global_func_param("bytes", *type::get_builtin_type("uint")));
+            // func __builtin_gc_stats(out : pointer(uint))
+            auto stats_func = detail::make_global_func(scope_root, "__builtin_gc_stats", type::get_unit_type());
+            stats_func->define_param(detail::make_global_func_param("out", type::make<type::pointer_type>(*type::get_builtin_type("uint"))));
+        }
+
+        {
+            auto const int_type = *type::get_builtin_type("int");
+            auto const uint_type = *type::get_builtin_type("uint");
+            auto const float_type = *type::get_builtin_type("float");
+            auto const bool_type = *type::get_builtin_type("bool");
+            auto const buf_type = type::make<type::pointer_type>(*type::get_builtin_type("char"));
+
+            // func int_length(i : int, base : uint) : uint
+            auto int_length_func = detail::make_global_func(scope_root, "__builtin_int_length", uint_type);
+            int_length_func->define_param(detail::make_global_func_param("i", int_type));
+            int_length_func->define_param(detail::make_global_func_param("base", uint_type));
+
+            // func uint_length(u : uint, base : uint) : uint
+            auto uint_length_func = detail::make_global_func(scope_root, "__builtin_uint_length", uint_type);
+            uint_length_func->define_param(detail::make_global_func_param("u", uint_type));
+            uint_length_func->define_param(detail::make_global_func_param("base", uint_type));
+
+            // func format_int(buf : pointer(char), i : int, base : uint) : uint
+            auto format_int_func = detail::make_global_func(scope_root, "__builtin_format_int", uint_type);
+            format_int_func->define_param(detail::make_global_func_param("buf", buf_type));
+            format_int_func->define_param(detail::make_global_func_param("i", int_type));
+            format_int_func->define_param(detail::make_global_func_param("base", uint_type));
+
+            // func format_uint(buf : pointer(char), u : uint, base : uint) : uint
+            auto format_uint_func = detail::make_global_func(scope_root, "__builtin_format_uint", uint_type);
+            format_uint_func->define_param(detail::make_global_func_param("buf", buf_type));
+            format_uint_func->define_param(detail::make_global_func_param("u", uint_type));
+            format_uint_func->define_param(detail::make_global_func_param("base", uint_type));
+
+            // func format_float(buf : pointer(char), f : float) : uint
+            auto format_float_func = detail::make_global_func(scope_root, "__builtin_format_float", uint_type);
+            format_float_func->define_param(detail::make_global_func_param("buf", buf_type));
+            format_float_func->define_param(detail::make_global_func_param("f", float_type));
+
+            // func parse_int(ptr : pointer(char), size : uint, base : uint, out : pointer(int)) : bool
+            auto parse_int_func = detail::make_global_func(scope_root, "__builtin_parse_int", bool_type);
+            parse_int_func->define_param(detail::make_global_func_param("ptr", buf_type));
+            parse_int_func->define_param(detail::make_global_func_param("size", uint_type));
+            parse_int_func->define_param(detail::make_global_func_param("base", uint_type));
+            parse_int_func->define_param(detail::make_global_func_param("out", type::make<type::pointer_type>(int_type)));
+
+            // func parse_float(ptr : pointer(char), size : uint, out : pointer(float)) : bool
+            auto parse_float_func = detail::make_global_func(scope_root, "__builtin_parse_float", bool_type);
+            parse_float_func->define_param(detail::make_global_func_param("ptr", buf_type));
+            parse_float_func->define_param(detail::make_global_func_param("size", uint_type));
+            parse_float_func->define_param(detail::make_global_func_param("out", type::make<type::pointer_type>(float_type)));
+        }
+
+        {
+            auto const char_ptr_type = type::make<type::pointer_type>(*type::get_builtin_type("char"));
+            auto const size_ptr_type = type::make<type::pointer_type>(*type::get_builtin_type("uint"));
+
+            // func read_line(size : pointer(uint)) : pointer(char)
+            auto read_line_func = detail::make_global_func(scope_root, "__builtin_read_line", char_ptr_type);
+            read_line_func->define_param(detail::make_global_func_param("size", size_ptr_type));
+
+            // func read_token(size : pointer(uint)) : pointer(char)
+            auto read_token_func = detail::make_global_func(scope_root, "__builtin_read_token", char_ptr_type);
+            read_token_func->define_param(detail::make_global_func_param("size", size_ptr_type));
+
+            // func read_all(size : pointer(uint)) : pointer(char)
+            auto read_all_func = detail::make_global_func(scope_root, "__builtin_read_all", char_ptr_type);
+            read_all_func->define_param(detail::make_global_func_param("size", size_ptr_type));
+
+            // func read_char() : int
+            detail::make_global_func(scope_root, "__builtin_read_char", *type::get_builtin_type("int"));
+
+            // func stdin_eof?() : bool
+            detail::make_global_func(scope_root, "__builtin_stdin_eof?", *type::get_builtin_type("bool"));
+        }
+
+        {
+            auto const uint_type = *type::get_builtin_type("uint");
+            auto const bool_type = *type::get_builtin_type("bool");
+            auto const char_ptr_type = type::make<type::pointer_type>(*type::get_builtin_type("char"));
+            auto const uint_ptr_type = type::make<type::pointer_type>(uint_type);
+
+            // func file_open(path : pointer(char), mode : pointer(char)) : uint
+            auto file_open_func = detail::make_global_func(scope_root, "__builtin_file_open", uint_type);
+            file_open_func->define_param(detail::make_global_func_param("path", char_ptr_type));
+            file_open_func->define_param(detail::make_global_func_param("mode", char_ptr_type));
+
+            // func file_close(handle : uint) : bool
+            auto file_close_func = detail::make_global_func(scope_root, "__builtin_file_close", bool_type);
+            file_close_func->define_param(detail::make_global_func_param("handle", uint_type));
+
+            // func file_write(handle : uint, data : pointer(char), size : uint) : bool
+            auto file_write_func = detail::make_global_func(scope_root, "__builtin_file_write", bool_type);
+            file_write_func->define_param(detail::make_global_func_param("handle", uint_type));
+            file_write_func->define_param(detail::make_global_func_param("data", char_ptr_type));
+            file_write_func->define_param(detail::make_global_func_param("size", uint_type));
+
+            // func file_flush(handle : uint) : bool
+            auto file_flush_func = detail::make_global_func(scope_root, "__builtin_file_flush", bool_type);
+            file_flush_func->define_param(detail::make_global_func_param("handle", uint_type));
+
+            // func file_read(handle : uint, buf : pointer(char), size : uint) : uint
+            auto file_read_func = detail::make_global_func(scope_root, "__builtin_file_read", uint_type);
+            file_read_func->define_param(detail::make_global_func_param("handle", uint_type));
+            file_read_func->define_param(detail::make_global_func_param("buf", char_ptr_type));
+            file_read_func->define_param(detail::make_global_func_param("size", uint_type));
+
+            // func file_read_all(handle : uint, size : pointer(uint)) : pointer(char)
+            auto file_read_all_func = detail::make_global_func(scope_root, "__builtin_file_read_all", char_ptr_type);
+            file_read_all_func->define_param(detail::make_global_func_param("handle", uint_type));
+            file_read_all_func->define_param(detail::make_global_func_param("size", uint_ptr_type));
+
+            // func file_size(handle : uint) : int
+            auto file_size_func = detail::make_global_func(scope_root, "__builtin_file_size", *type::get_builtin_type("int"));
+            file_size_func->define_param(detail::make_global_func_param("handle", uint_type));
+
+            // func mmap_read(path : pointer(char), size : pointer(uint)) : pointer(char)
+            auto mmap_read_func = detail::make_global_func(scope_root, "__builtin_mmap_read", char_ptr_type);
+            mmap_read_func->define_param(detail::make_global_func_param("path", char_ptr_type));
+            mmap_read_func->define_param(detail::make_global_func_param("size", uint_ptr_type));
+
+            // func munmap(data : pointer(char), size : uint) : bool
+            auto munmap_func = detail::make_global_func(scope_root, "__builtin_munmap", bool_type);
+            munmap_func->define_param(detail::make_global_func_param("data", char_ptr_type));
+            munmap_func->define_param(detail::make_global_func_param("size", uint_type));
+
+            // func next_line(data : pointer(char), size : uint, pos : pointer(uint), line_size : pointer(uint)) : pointer(char)
+            auto next_line_func = detail::make_global_func(scope_root, "__builtin_next_line", char_ptr_type);
+            next_line_func->define_param(detail::make_global_func_param("data", char_ptr_type));
+            next_line_func->define_param(detail::make_global_func_param("size", uint_type));
+            next_line_func->define_param(detail::make_global_func_param("pos", uint_ptr_type));
+            next_line_func->define_param(detail::make_global_func_param("line_size", uint_ptr_type));
+        }
+
+        {
+            auto const uint_type = *type::get_builtin_type("uint");
+
+            // func task_spawn(f) : uint
+            auto task_spawn_func = detail::make_global_func(scope_root, "__builtin_task_spawn", uint_type);
+            task_spawn_func->define_param(detail::make_global_func_param("f", dummy_template_type));
+
+            // func task_join(handle : uint)
+            auto task_join_func = detail::make_global_func(scope_root, "__builtin_task_join", type::get_unit_type());
+            task_join_func->define_param(detail::make_global_func_param("handle", uint_type));
+
+            // func num_workers() : uint
+            detail::make_global_func(scope_root, "__builtin_num_workers", uint_type);
+        }
+
+        {
+            auto const uint_type = *type::get_builtin_type("uint");
+            auto const bool_type = *type::get_builtin_type("bool");
+
+            // func ring_new(capacity : uint) : uint
+            auto ring_new_func = detail::make_global_func(scope_root, "__builtin_ring_new", uint_type);
+            ring_new_func->define_param(detail::make_global_func_param("capacity", uint_type));
+
+            // func ring_capacity(ring : uint) : uint
+            auto ring_capacity_func = detail::make_global_func(scope_root, "__builtin_ring_capacity", uint_type);
+            ring_capacity_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_size(ring : uint) : uint
+            auto ring_size_func = detail::make_global_func(scope_root, "__builtin_ring_size", uint_type);
+            ring_size_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_try_claim_push(ring : uint) : uint
+            auto ring_try_claim_push_func = detail::make_global_func(scope_root, "__builtin_ring_try_claim_push", uint_type);
+            ring_try_claim_push_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_claim_push(ring : uint) : uint
+            auto ring_claim_push_func = detail::make_global_func(scope_root, "__builtin_ring_claim_push", uint_type);
+            ring_claim_push_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_publish_push(ring : uint, pos : uint)
+            auto ring_publish_push_func = detail::make_global_func(scope_root, "__builtin_ring_publish_push", type::get_unit_type());
+            ring_publish_push_func->define_param(detail::make_global_func_param("ring", uint_type));
+            ring_publish_push_func->define_param(detail::make_global_func_param("pos", uint_type));
+
+            // func ring_try_claim_pop(ring : uint) : uint
+            auto ring_try_claim_pop_func = detail::make_global_func(scope_root, "__builtin_ring_try_claim_pop", uint_type);
+            ring_try_claim_pop_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_claim_pop(ring : uint) : uint
+            auto ring_claim_pop_func = detail::make_global_func(scope_root, "__builtin_ring_claim_pop", uint_type);
+            ring_claim_pop_func->define_param(detail::make_global_func_param("ring", uint_type));
+
+            // func ring_release_pop(ring : uint, pos : uint)
+            auto ring_release_pop_func = detail::make_global_func(scope_root, "__builtin_ring_release_pop", type::get_unit_type());
+            ring_release_pop_func->define_param(detail::make_global_func_param("ring", uint_type));
+            ring_release_pop_func->define_param(detail::make_global_func_param("pos", uint_type));
+
+            // func spsc_new() : uint
+            detail::make_global_func(scope_root, "__builtin_spsc_new", uint_type);
+
+            // func spsc_empty?(queue : uint) : bool
+            auto spsc_empty_func = detail::make_global_func(scope_root, "__builtin_spsc_empty?", bool_type);
+            spsc_empty_func->define_param(detail::make_global_func_param("queue", uint_type));
+
+            // func spsc_push(queue : uint, box : pointer)
+            auto spsc_push_func = detail::make_global_func(scope_root, "__builtin_spsc_push", type::get_unit_type());
+            spsc_push_func->define_param(detail::make_global_func_param("queue", uint_type));
+            spsc_push_func->define_param(detail::make_global_func_param("box", type::make<type::pointer_type>(dummy_template_type)));
+
+            // func spsc_try_pop(queue : uint, out : pointer) : bool
+            auto spsc_try_pop_func = detail::make_global_func(scope_root, "__builtin_spsc_try_pop", bool_type);
+            spsc_try_pop_func->define_param(detail::make_global_func_param("queue", uint_type));
+            spsc_try_pop_func->define_param(detail::make_global_func_param("out", type::make<type::pointer_type>(dummy_template_type)));
+
+            // func spsc_pop(queue : uint, out : pointer)
+            auto spsc_pop_func = detail::make_global_func(scope_root, "__builtin_spsc_pop", type::get_unit_type());
+            spsc_pop_func->define_param(detail::make_global_func_param("queue", uint_type));
+            spsc_pop_func->define_param(detail::make_global_func_param("out", type::make<type::pointer_type>(dummy_template_type)));
+
+            // func arena_new(chunk_size : uint) : uint
+            auto arena_new_func = detail::make_global_func(scope_root, "__builtin_arena_new", uint_type);
+            arena_new_func->define_param(detail::make_global_func_param("chunk_size", uint_type));
+
+            // func arena_switch(arena : uint) : uint
+            auto arena_switch_func = detail::make_global_func(scope_root, "__builtin_arena_switch", uint_type);
+            arena_switch_func->define_param(detail::make_global_func_param("arena", uint_type));
+
+            // func arena_release(arena : uint)
+            auto arena_release_func = detail::make_global_func(scope_root, "__builtin_arena_release", type::get_unit_type());
+            arena_release_func->define_param(detail::make_global_func_param("arena", uint_type));
+
+            // func arena_allocated(arena : uint) : uint
+            auto arena_allocated_func = detail::make_global_func(scope_root, "__builtin_arena_allocated", uint_type);
+            arena_allocated_func->define_param(detail::make_global_func_param("arena", uint_type));
         }
 
         // Operators
@@ -0,0 +1,223 @@
+#if !defined DACHS_SEMANTICS_LAMBDA_ESCAPE_CHECKER_HPP_INCLUDED
+#define      DACHS_SEMANTICS_LAMBDA_ESCAPE_CHECKER_HPP_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <unordered_set>
+#include <vector>
+
+#include "dachs/ast/ast.hpp"
+#include "dachs/ast/ast_walker.hpp"
+#include "dachs/semantics/scope.hpp"
+#include "dachs/semantics/symbol.hpp"
+#include "dachs/helper/variant.hpp"
+#include "dachs/helper/util.hpp"
+
+namespace dachs {
+namespace semantics {
+namespace detail {
+
+using std::size_t;
+using helper::variant::get_as;
+
+// Note:
+// Find lambdas which never outlive the invocation they are passed to, like
+// a do-block passed to 'array.each'.  A lambda passed directly as an argument
+// does not escape when the callee only invokes the corresponding parameter or
+// passes it to another non-escaping parameter.  Any other use of the parameter
+// (storing, returning, capturing, passing to a builtin such as task spawn) is
+// regarded as an escape.  The capture struct of a non-escaping lambda can be
+// allocated on the caller's stack.
+class lambda_escape_checker {
+
+    class param_use_checker {
+        lambda_escape_checker &checker;
+        symbol::var_symbol const& param;
+        bool escaped = false;
+
+        bool refers_param(ast::node::var_ref const& var) const
+        {
+            return !var->symbol.expired() && *var->symbol.lock() == *param;
+        }
+
+        bool refers_param(ast::node::any_expr const& e) const
+        {
+            auto const var = get_as<ast::node::var_ref>(e);
+            return var && refers_param(*var);
+        }
+
+    public:
+
+        param_use_checker(lambda_escape_checker &c, symbol::var_symbol const& p) noexcept
+            : checker(c), param(p)
+        {}
+
+        template<class Walker>
+        void visit(ast::node::func_invocation const& invocation, Walker const& w)
+        {
+            if (escaped) {
+                return;
+            }
+
+            // Note:
+            // Invoking the parameter does not make it escape.
+            if (!refers_param(invocation->child)) {
+                w(invocation->child);
+            }
+
+            for (auto const idx : helper::indices(invocation->args)) {
+                auto &arg = invocation->args[idx];
+                if (!refers_param(arg)) {
+                    w(arg);
+                } else if (!checker.is_non_escaping_arg(invocation, idx)) {
+                    escaped = true;
+                    return;
+                }
+            }
+        }
+
+        template<class Walker>
+        void visit(ast::node::var_ref const& var, Walker const&)
+        {
+            if (refers_param(var)) {
+                escaped = true;
+            }
+        }
+
+        template<class Walker>
+        void visit(ast::node::lambda_expr const& lambda, Walker const&)
+        {
+            // Note:
+            // Captured variables of the lambda are in its receiver.
+            ast::walk_topdown(lambda->receiver, *this);
+        }
+
+        template<class Node, class Walker>
+        void visit(Node const&, Walker const& w)
+        {
+            if (!escaped) {
+                w();
+            }
+        }
+
+        bool check(ast::node::function_definition &def)
+        {
+            ast::walk_topdown(def, *this);
+            return !escaped;
+        }
+    };
+
+    // Note:
+    // A parameter being checked is assumed not to escape.  It makes a recursive
+    // function which only passes the parameter to itself non-escaping.
+    // When the outermost check fails, the results which were deduced from the
+    // assumption are discarded.  Results of escaping parameters are kept.
+    std::map<std::pair<scope::func_scope, size_t>, bool> param_results;
+    std::vector<std::pair<scope::func_scope, size_t>> assumed;
+    size_t depth = 0u;
+    std::unordered_set<ast::node::tuple_literal> stack_receivers;
+
+    bool is_non_escaping_param(scope::func_scope const& callee, size_t const idx)
+    {
+        auto const key = std::make_pair(callee, idx);
+        auto const result = param_results.find(key);
+        if (result != std::end(param_results)) {
+            return result->second;
+        }
+
+        param_results[key] = true;
+        assumed.push_back(key);
+
+        ++depth;
+        auto def = callee->get_ast_node();
+        param_use_checker checker{*this, callee->params[idx]};
+        auto const non_escaping = checker.check(def);
+        --depth;
+
+        param_results[key] = non_escaping;
+
+        if (depth == 0u) {
+            if (!non_escaping) {
+                for (auto const& k : assumed) {
+                    if (param_results[k]) {
+                        param_results.erase(k);
+                    }
+                }
+            }
+            assumed.clear();
+        }
+
+        return non_escaping;
+    }
+
+public:
+
+    bool is_non_escaping_arg(ast::node::func_invocation const& invocation, size_t const idx)
+    {
+        if (invocation->callee_scope.expired() || invocation->is_monad_invocation) {
+            return false;
+        }
+
+        auto const callee = invocation->callee_scope.lock();
+        if (callee->is_builtin || callee->is_template()) {
+            return false;
+        }
+
+        // Note:
+        // Lambda invocations have their receiver as an extra parameter.
+        // Such calls are not tracked.
+        if (callee->params.size() != invocation->args.size()) {
+            return false;
+        }
+
+        return is_non_escaping_param(callee, idx);
+    }
+
+    template<class Walker>
+    void visit(ast::node::function_definition const& def, Walker const& w)
+    {
+        if (def->is_template()) {
+            return;
+        }
+        w();
+    }
+
+    template<class Walker>
+    void visit(ast::node::class_definition const& def, Walker const& w)
+    {
+        if (!def->scope.expired() && def->scope.lock()->is_template()) {
+            return;
+        }
+        w();
+    }
+
+    template<class Walker>
+    void visit(ast::node::func_invocation const& invocation, Walker const& w)
+    {
+        for (auto const idx : helper::indices(invocation->args)) {
+            auto const lambda = get_as<ast::node::lambda_expr>(invocation->args[idx]);
+            if (lambda && is_non_escaping_arg(invocation, idx)) {
+                stack_receivers.insert((*lambda)->receiver);
+            }
+        }
+        w();
+    }
+
+    template<class Node, class Walker>
+    void visit(Node const&, Walker const& w)
+    {
+        w();
+    }
+
+    auto get_stack_receivers()
+    {
+        return std::move(stack_receivers);
+    }
+};
+
+} // namespace detail
+} // namespace semantics
+} // namespace dachs
+
+#endif    // DACHS_SEMANTICS_LAMBDA_ESCAPE_CHECKER_HPP_INCLUDED
@@ -16,10 +16,10 @@
 namespace dachs {
 namespace semantics {
 
-semantics_context analyze_semantics(ast::ast &a, syntax::importer &i)
+semantics_context analyze_semantics(ast::ast &a, syntax::importer &i, helper::time_report &report)
 {
-    auto tree = analyze_symbols_forward(a, i);
-    return check_semantics(a, tree, i);
+    auto tree = report.measure("forward analysis", [&]{ return analyze_symbols_forward(a, i); });
+    return report.measure("symbol analysis", [&]{ return check_semantics(a, tree, i); });
 
     // TODO: Get type of global function variables' type on visit node::function_definition
     // Note:
@@ -28,5 +28,11 @@ semantics_context analyze_semantics(ast::ast &a, syntax::importer &i)
     // If so, type calculation pass should be separated from symbol analysis pass.
 }
 
+semantics_context analyze_semantics(ast::ast &a, syntax::importer &i)
+{
+    helper::time_report disabled;
+    return analyze_semantics(a, i, disabled);
+}
+
 } // namespace semantics
 } // namespace dachs
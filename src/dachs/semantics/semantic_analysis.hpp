@@ -5,6 +5,7 @@
 #include "dachs/parser/importer.hpp"
 #include "dachs/semantics/scope_fwd.hpp"
 #include "dachs/semantics/semantics_context.hpp"
+#include "dachs/helper/time_report.hpp"
 
 namespace dachs {
 namespace semantics {
@@ -12,6 +13,10 @@ namespace semantics {
 // FIXME: argument should be const
 semantics_context analyze_semantics(ast::ast &a, syntax::importer &i);
 
+// Note:
+// Record forward analysis and symbol analysis as separate phases.
+semantics_context analyze_semantics(ast::ast &a, syntax::importer &i, helper::time_report &report);
+
 } // namespace semantics
 } // namespace dachs
 
@@ -2,7 +2,10 @@
 #define      DACHS_SEMANTICS_SEMANTICS_CONTEXT_HPP_INCLUDED
 
 #include <cstddef>
+#include <map>
+#include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <iostream>
 #include <utility>
 #include <string>
@@ -61,6 +64,11 @@ struct semantics_context {
     lambda_captures_type lambda_captures;
     boost::optional<scope::func_scope> main_arg_constructor;
     std::unordered_map<type::class_type, scope::weak_func_scope> copiers;
+    std::unordered_set<ast::node::tuple_literal> stack_lambda_receivers;
+
+    // Note:
+    // Template name -> types of each instantiation in order.  Reported by --stats.
+    std::map<std::string, std::vector<std::string>> template_instantiations;
 
     semantics_context(semantics_context const&) = delete;
     semantics_context &operator=(semantics_context const&) = delete;
@@ -87,6 +95,14 @@ struct semantics_context {
         return copier_of(*c);
     }
 
+    // Note:
+    // The receiver of a lambda which does not escape from the invocation it is
+    // passed to.  See lambda_escape_checker.
+    bool is_stack_lambda_receiver(ast::node::tuple_literal const& receiver) const
+    {
+        return stack_lambda_receivers.find(receiver) != std::end(stack_lambda_receivers);
+    }
+
     template<class Stream = std::ostream>
     void dump_lambda_captures(Stream &out = std::cerr) const
     {
@@ -36,6 +36,12 @@ static std::vector<builtin_type> const builtin_types
         make<builtin_type>("char"),
         make<builtin_type>("bool"),
         make<builtin_type>("symbol"),
+        make<builtin_type>("i8"),
+        make<builtin_type>("i16"),
+        make<builtin_type>("i32"),
+        make<builtin_type>("u8"),
+        make<builtin_type>("u32"),
+        make<builtin_type>("f32"),
     };
 
 template<class T>
@@ -326,6 +326,31 @@ struct builtin_type final : public named_type {
     {
         return name != "symbol";
     }
+
+    bool is_signed_integer() const noexcept
+    {
+        return name == "int" || name == "i8" || name == "i16" || name == "i32";
+    }
+
+    bool is_unsigned_integer() const noexcept
+    {
+        return name == "uint" || name == "u8" || name == "u32";
+    }
+
+    bool is_integer() const noexcept
+    {
+        return is_signed_integer() || is_unsigned_integer();
+    }
+
+    bool is_floating_point() const noexcept
+    {
+        return name == "float" || name == "f32";
+    }
+
+    bool is_numeric() const noexcept
+    {
+        return is_integer() || is_floating_point();
+    }
 };
 
 // This class may not be needed because class from class template is instanciated at the point on resolving a symbol of class templates
@@ -6,6 +6,10 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <algorithm>
+#include <thread>
 
 #include <signal.h>
 
@@ -19,6 +23,12 @@
 #include "dachs/helper/backtrace_printer.hpp"
 #include "dachs/exception.hpp"
 #include "dachs/codegen/opt_level.hpp"
+#include "dachs/codegen/gc_options.hpp"
+#include "dachs/codegen/debug_options.hpp"
+#include "dachs/codegen/instrumentation_options.hpp"
+#include "dachs/codegen/pgo_options.hpp"
+#include "dachs/helper/time_report.hpp"
+#include "dachs/size.hpp"
 
 namespace dachs {
 namespace cmdline {
@@ -95,6 +105,32 @@ auto get_substitution_option(std::string const& s, char const* const prefix)
     return result;
 }
 
+// Note:
+// Parse a size like "64M".  K, M and G suffixes are available.
+bool parse_size_option(std::string const& s, char const* const prefix, std::uint64_t &result)
+{
+    return runtime::parse_size(s.c_str() + std::strlen(prefix), result);
+}
+
+// Note:
+// Parse a positive integer without any suffix.
+bool parse_count_option(std::string const& s, char const* const prefix, std::uint64_t &result)
+{
+    auto const value_str = s.substr(std::strlen(prefix));
+    if (value_str.empty() || value_str.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+
+    errno = 0;
+    auto const value = std::strtoull(value_str.c_str(), nullptr, 10);
+    if (errno == ERANGE || value == 0u) {
+        return false;
+    }
+
+    result = value;
+    return true;
+}
+
 template<class T>
 auto &operator+=(std::vector<T> &lhs, std::vector<T> &&rhs)
 {
@@ -111,12 +147,13 @@ auto parse_command_options(ArgPtr arg)
 {
     struct {
         std::vector<char const*> rest_args;
+        std::vector<std::string> invalid_args;
         std::vector<std::string> source_files;
         std::vector<std::string> libdirs;
         bool debug_compiler = false;
         bool enable_color = true;
         bool run = false;
-        codegen::opt_level opt = codegen::opt_level::none;
+        compile_options compile_opts;
         std::vector<std::string> run_args;
         std::vector<std::string> importdirs;
         bool help = false;
@@ -128,6 +165,14 @@ auto parse_command_options(ArgPtr arg)
     std::string const debug_str = "--debug";
     std::string const release_str = "--release";
     std::string const help_str = "--help";
+    std::string const gc_incremental_str = "--gc-incremental";
+    std::string const heap_profile_str = "--heap-profile";
+    std::string const profile_functions_str = "--profile-functions";
+    std::string const debug_info_str = "--debug-info";
+    std::string const frame_pointer_str = "--frame-pointer";
+    std::string const profile_generate_str = "--profile-generate";
+    std::string const time_report_str = "--time-report";
+    std::string const stats_str = "--stats";
 
     for (; *arg; ++arg) {
         if (boost::algorithm::starts_with(*arg, "--runtimedir=")) {
@@ -147,13 +192,55 @@ auto parse_command_options(ArgPtr arg)
             }
             return cmdopts;
         } else if (*arg == debug_str) {
-            cmdopts.opt = codegen::opt_level::debug;
+            cmdopts.compile_opts.opt = codegen::opt_level::debug;
         } else if (*arg == release_str) {
-            cmdopts.opt = codegen::opt_level::release;
+            cmdopts.compile_opts.opt = codegen::opt_level::release;
         } else if (boost::algorithm::starts_with(*arg, "--libdir=")) {
             cmdopts.importdirs += get_substitution_option(*arg, "--libdir=");
         } else if (*arg == help_str) {
             cmdopts.help = true;
+        } else if (*arg == gc_incremental_str) {
+            cmdopts.compile_opts.gc.incremental = true;
+        } else if (*arg == heap_profile_str) {
+            cmdopts.compile_opts.gc.heap_profile = true;
+        } else if (*arg == profile_functions_str) {
+            cmdopts.compile_opts.instrumentation.profile_functions = true;
+        } else if (*arg == debug_info_str || *arg == std::string{"-g"}) {
+            cmdopts.compile_opts.debug_info.debug_info = true;
+        } else if (*arg == frame_pointer_str) {
+            cmdopts.compile_opts.debug_info.frame_pointer = true;
+        } else if (*arg == profile_generate_str) {
+            cmdopts.compile_opts.pgo.generate_file = "dachs.profdata";
+        } else if (boost::algorithm::starts_with(*arg, profile_generate_str + '=')) {
+            cmdopts.compile_opts.pgo.generate_file = std::string{*arg}.substr(profile_generate_str.size() + 1u);
+        } else if (boost::algorithm::starts_with(*arg, "--profile-use=")) {
+            cmdopts.compile_opts.pgo.use_file = std::string{*arg}.substr(std::strlen("--profile-use="));
+        } else if (*arg == time_report_str || *arg == time_report_str + "=table") {
+            cmdopts.compile_opts.time_report = helper::time_report::format::table;
+        } else if (*arg == time_report_str + "=json") {
+            cmdopts.compile_opts.time_report = helper::time_report::format::json;
+        } else if (*arg == stats_str) {
+            cmdopts.compile_opts.stats = true;
+        } else if (boost::algorithm::starts_with(*arg, "--codegen-threads=")) {
+            std::uint64_t threads;
+            if (parse_count_option(*arg, "--codegen-threads=", threads)) {
+                // Note: More threads than cores only consume memory.
+                cmdopts.compile_opts.codegen_threads = std::min<std::uint64_t>(threads, std::max(std::thread::hardware_concurrency(), 1u));
+            } else {
+                cmdopts.invalid_args.emplace_back(*arg);
+            }
+        } else if (boost::algorithm::starts_with(*arg, "--gc-markers=")) {
+            if (!parse_size_option(*arg, "--gc-markers=", cmdopts.compile_opts.gc.markers)) {
+                cmdopts.invalid_args.emplace_back(*arg);
+            }
+        } else if (boost::algorithm::starts_with(*arg, "--gc-initial-heap=")) {
+            if (!parse_size_option(*arg, "--gc-initial-heap=", cmdopts.compile_opts.gc.initial_heap_size)) {
+                cmdopts.invalid_args.emplace_back(*arg);
+            }
+        } else if (boost::algorithm::starts_with(*arg, "--gc-free-space-divisor=")) {
+            if (!parse_size_option(*arg, "--gc-free-space-divisor=", cmdopts.compile_opts.gc.free_space_divisor)) {
+                cmdopts.invalid_args.emplace_back(*arg);
+            }
         } else {
             cmdopts.rest_args.emplace_back(*arg);
         }
@@ -204,7 +291,7 @@ int main(int const, char const* const argv[])
         [argv]()
         {
             std::cerr << "OVERVIEW\n  Dachs compiler\n\n"
-                      << "USAGE\n  " << argv[0] << " [--dump-ast|--dump-sym-table|--emit-llvm|--output-obj|--check-syntax] [--debug-compiler] [--debug|--release] [--libdir={path}] [--runtimedir={path}] [--disable-color] {file} [--run [args...]]\n" <<
+                      << "USAGE\n  " << argv[0] << " [--dump-ast|--dump-sym-table|--emit-llvm|--output-obj|--check-syntax] [--debug-compiler] [--debug|--release] [--gc-*] [--heap-profile] [--profile-functions] [--debug-info] [--frame-pointer] [--profile-generate[={file}]|--profile-use={file}] [--time-report[=json]] [--stats] [--codegen-threads={n}] [--libdir={path}] [--runtimedir={path}] [--disable-color] {file} [--run [args...]]\n" <<
 R"(
 OPTIONS
   --dump-ast           Output AST to STDOUT
@@ -215,6 +302,28 @@ OPTIONS
   --debug-compiler     Output debug information to STDERR
   --debug              Do not optimize (equivalent to -O0)
   --release            Do aggressive optimization (equivalent to -O3)
+  --gc-markers={n}     Number of GC marker threads (default: number of CPUs)
+  --gc-incremental     Enable incremental GC to shorten pauses
+  --gc-initial-heap={size}
+                       Expand GC heap at startup (e.g. 64M)
+  --gc-free-space-divisor={n}
+                       Larger value collects more frequently with smaller heap
+  --heap-profile       Count allocations per source location and report them at exit
+  --profile-functions  Count calls and cycles of each function and report them with
+                       the call graph at exit
+  --debug-info, -g     Emit DWARF debug information mapping code to source lines
+  --frame-pointer      Keep frame pointers for stack unwinding by profilers
+  --profile-generate[={file}]
+                       Count branches at runtime and merge them into {file} at exit
+                       (default: dachs.profdata)
+  --profile-use={file} Optimize with branch weights and function entry counts in {file}
+  --time-report[={table|json}]
+                       Report time and peak memory of each compilation phase to STDERR
+  --stats              Report template instantiations and IR instructions of each function
+                       before and after optimization to STDERR
+  --codegen-threads={n}
+                       Split each module into {n} objects and generate them in parallel
+                       {n} is limited to the number of hardware threads
   --libdir={path}      Add import path
   --runtimedir={path}  Specify path of runtime directory
   --disable-color      Disable colorful output
@@ -236,12 +345,19 @@ URL
         return 0;
     }
 
+    if (!cmdopts.invalid_args.empty()) {
+        for (auto const& a : cmdopts.invalid_args) {
+            std::cerr << "Invalid value of option: '" << a << "'\n";
+        }
+        return 2;
+    }
+
     if (cmdopts.source_files.empty()) {
         std::cerr << "No input file: Source file must end with '.dcs'.\n";
         return 2;
     }
 
-    dachs::compiler compiler{cmdopts.enable_color, cmdopts.debug_compiler, cmdopts.opt};
+    dachs::compiler compiler{cmdopts.enable_color, cmdopts.debug_compiler, cmdopts.compile_opts};
 
     switch (cmdopts.rest_args.size()) {
 
@@ -4461,4 +4461,80 @@ BOOST_AUTO_TEST_CASE(unterminated_block_check)
     )");
 }
 
+BOOST_AUTO_TEST_CASE(fixed_width_types)
+{
+    CHECK_NO_THROW_SEMANTIC_ERROR(R"(
+        func main
+            a := 42i8 + 1i8
+            b := 255u8 * 2u8
+            c := 3.14f32 / 2.0f32
+            d := -2147483648i32
+            e := 65535i16 as i32 as u32 as uint
+            f := c as float as f32 as int as i8
+            g := 'a' as u8
+            var p := new pointer(u8){10u}
+            p[0] = b
+        end
+
+        func f(x : i16) : i16
+            ret x * 2i16
+        end
+    )");
+
+    // Out of range
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            256u8
+        end
+    )");
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            129i8
+        end
+    )");
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            128i8
+        end
+    )");
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            32768i16
+        end
+    )");
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            2147483648i32
+        end
+    )");
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            -129i8
+        end
+    )");
+
+    // Minimum values of signed types
+    CHECK_NO_THROW_SEMANTIC_ERROR(R"(
+        func main
+            a := -128i8
+            b := -32768i16
+            c := -2147483648i32
+        end
+    )");
+
+    // No implicit conversion
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            1i8 + 1
+        end
+    )");
+
+    // Invalid conversion between builtin types
+    CHECK_THROW_SEMANTIC_ERROR(R"(
+        func main
+            true as i8
+        end
+    )");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
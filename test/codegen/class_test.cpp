@@ -747,6 +747,50 @@ BOOST_AUTO_TEST_CASE(do_not_degrade)
     )");
 }
 
+BOOST_AUTO_TEST_CASE(nested_objects_in_one_block)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        class Vec
+            x, y
+        end
+
+        class Shared
+            a
+
+            copy
+                ret new Shared{@a}
+            end
+        end
+
+        class Particle
+            pos, vel, pair, shared, name
+
+            init(@pos, @vel, @shared)
+                @pair := (new Vec{1, 2}, 3.0)
+                @name := "particle"
+            end
+        end
+
+        func main
+            var p := new Particle{new Vec{1.0, 2.0}, new Vec{0.5, 0.5}, new Shared{42}}
+            p.pos = new Vec{3.0, 4.0}
+            p.pos.x.println
+            p.pair[0].y.println
+            p.shared.a.println
+            p.name.println
+
+            var q := p
+            q.vel.y.println
+
+            var ps := [p, q]
+            ps[1].pos.x.println
+
+            t := (new Vec{1, 2}, (new Vec{3, 4}, 5))
+            t[1][0].x.println
+        end
+    )");
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,10 +11,32 @@
 #include "dachs/codegen/llvmir/ir_emitter.hpp"
 #include "dachs/exception.hpp"
 
+#include <llvm/IR/Module.h>
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
+# include <llvm/Analysis/Verifier.h>
+#elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
+# include <llvm/IR/Verifier.h>
+#else
+# error LLVM: Not supported version.
+#endif
+
 #include <boost/test/included/unit_test.hpp>
 
 static dachs::syntax::parser p;
 
+// Note:
+// For tests which transform emitted modules.
+static bool is_valid_module(llvm::Module const& m)
+{
+#if (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 4)
+    return !llvm::verifyModule(m, llvm::ReturnStatusAction);
+#elif (LLVM_VERSION_MAJOR == 3 && LLVM_VERSION_MINOR <= 5)
+    return !llvm::verifyModule(m);
+#else
+# error LLVM: Not supported version.
+#endif
+}
+
 #define CHECK_NO_THROW_CODEGEN_ERROR(...) do { \
             auto t = p.parse((__VA_ARGS__), "test_file"); \
             dachs::syntax::importer i{{}, "test_file"}; \
@@ -5,6 +5,8 @@
 #include "../test_helper.hpp"
 #include "./codegen_test_helper.hpp"
 
+#include <cstring>
+
 using namespace dachs::test;
 
 BOOST_AUTO_TEST_SUITE(codegen_llvm)
@@ -1435,6 +1437,544 @@ BOOST_AUTO_TEST_CASE(begin_expr)
     )");
 }
 
+BOOST_AUTO_TEST_CASE(number_conversion_builtins)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        func main
+            var buf := new pointer(char){32u}
+
+            __builtin_format_int(buf, -42, 10u).println
+            __builtin_format_uint(buf, 42u, 16u).println
+            __builtin_format_float(buf, 3.14).println
+            __builtin_int_length(-42, 10u).println
+            __builtin_uint_length(255u, 2u).println
+
+            var i := new pointer(int){1u}
+            __builtin_parse_int(buf, 3u, 10u, i).println
+            i[0].println
+
+            var f := new pointer(float){1u}
+            __builtin_parse_float(buf, 4u, f).println
+            f[0].println
+        end
+    )");
+
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.numeric
+        import std.string
+
+        func main
+            (-42).to_string.println
+            255u.to_string(16u).println
+            (3.14).to_string.println
+            (1.0 as string).println
+
+            ok, i := "-1234".parse_int
+            println(i) if ok
+            ok2, h := "ff".parse_int(16u)
+            println(h) if ok2
+            ok3, f := "1.5e10".parse_float
+            println(f) if ok3
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(string_builder)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.string
+
+        func main
+            var b := new string_builder
+            b << "answer: " << 42 << ' ' << 42u << ' ' << 3.14 << ' ' << true
+            b.reserve(1024u)
+            b.build.println
+
+            var b2 := new string_builder{4u}
+            var i := 0
+            for i < 100
+                b2 << i << ','
+                i += 1
+            end
+            b2.size.println
+            b2.build.println
+
+            (new string_builder{["foo", "bar"]}).build.println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(stdin_builtins)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        func main
+            var size := new pointer(uint){1u}
+            p := __builtin_read_line(size)
+            println(p) unless __builtin_null?(p)
+            __builtin_read_token(size)
+            __builtin_read_all(size)
+            __builtin_read_char().println
+            __builtin_stdin_eof?().println
+        end
+    )");
+
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.stdin
+
+        func main
+            ok, line := read_line()
+            line.println if ok
+
+            var r := new stdin_reader
+            ok2, c := r.read_char
+            println(c) if ok2
+
+            r.each_token do |t|
+                t.println
+            end
+
+            each_line do |l|
+                l.println
+            end
+
+            read_all().println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(file_builtins)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        func main
+            var path := new pointer(char){2u}
+            path[0] = 'a'
+            var mode := new pointer(char){2u}
+            mode[0] = 'w'
+
+            h := __builtin_file_open(path, mode)
+            __builtin_file_write(h, path, 1u).println
+            __builtin_file_flush(h).println
+            __builtin_file_size(h).println
+            __builtin_file_read(h, path, 1u).println
+            var size := new pointer(uint){1u}
+            __builtin_file_read_all(h, size)
+            __builtin_file_close(h).println
+
+            p := __builtin_mmap_read(path, size)
+            var pos := new pointer(uint){1u}
+            var len := new pointer(uint){1u}
+            __builtin_next_line(p, size[0], pos, len)
+            __builtin_munmap(p, size[0]).println
+        end
+    )");
+
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.file
+
+        func main
+            var f := open("out.txt", "w")
+            if f.open?
+                f << "foo" << "bar"
+                f.write_line("baz")
+                f.close
+            end
+
+            ok, content := read_file("out.txt")
+            content.println if ok
+            write_file("out.txt", "hello").println
+
+            m := mmap_read("out.txt")
+            if m.mapped?
+                (m as string).println
+                m.chars.size.println
+                m.each_line do |l|
+                    l.println
+                end
+                m.close
+            end
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(fixed_width_types)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        func sum(a : [u8])
+            var s, var i := 0u32, 0u
+            for i < a.size
+                s += a[i] as u32
+                i += 1u
+            end
+            ret s
+        end
+
+        func main
+            a := 42i8 + 1i8
+            a.println
+            (-a).println
+            (200u8 >> 1u8).println
+            (1i16 << 3i16).println
+            (100000i32 * 3i32).println
+            (4000000000u32 / 3u32).println
+            (3.14f32 * 2.0f32).println
+            (1.5f32 < 2.5f32).println
+
+            (a as int).println
+            (300 as u8).println
+            (255u8 as i8).println
+            (255u8 as int).println
+            (-1i8 as uint).println
+            (3.9f32 as i32).println
+            (3.14 as f32).println
+            (1.5f32 as float).println
+            ('a' as u8 as char).println
+
+            sum([1u8, 2u8, 255u8]).println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(task_builtins)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        func main
+            h := __builtin_task_spawn(-> println(42))
+            __builtin_task_join(h)
+
+            a := 10
+            h2 := __builtin_task_spawn(-> println(a))
+            __builtin_task_join(h2)
+            __builtin_num_workers().println
+        end
+    )");
+
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.task
+
+        func main
+            var results := new [int]{4u, 0}
+            var tasks := [] : [task]
+            for i in [0, 1, 2, 3]
+                tasks << spawn(-> do
+                    results[i] = i * i
+                end)
+            end
+            join(tasks)
+            results.println
+
+            var t := spawn(-> println("hello"))
+            t.join
+            t.join
+            t.joined?.println
+            num_workers().println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(parallel_array_algorithms)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.parallel
+
+        func main
+            small := [1, 2, 3, 4]
+            large := new [int]{10000u, 3}
+
+            small.pmap {|i| i * i }.println
+            large.pmap {|i| i as float }.size.println
+            large.peach {|i| i + 1 }
+            small.pfoldl(0) {|a, b| a + b }.println
+            large.pfoldl(0) {|a, b| a + b }.println
+            large.pfilter {|i| i % 2 == 1 }.size.println
+            large.pcount_by {|i| i > 2 }.println
+            large.pmax_by {|l, r| l < r }.println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(channel)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.channel
+        import std.task
+
+        func main
+            var ch := new channel{4u, 0}
+            ch.capacity.println
+            ch.try_send(1).println
+            ch << 2 << 3
+            ch.size.println
+            ch.recv.println
+            ok, v := ch.try_recv
+            println(v) if ok
+
+            var tasks := [] : [task]
+            for i in [0, 1, 2, 3]
+                tasks << spawn(-> ch.send(i))
+            end
+            var sum := 0
+            for j in [0, 1, 2, 3]
+                sum += ch.recv
+            end
+            join(tasks)
+            sum.println
+            ch.empty?.println
+
+            var q := new spsc_queue{""}
+            var t := spawn(-> q << "foo" << "bar")
+            q.recv.println
+            q.recv.println
+            ok2, s := q.try_recv
+            println(s) unless ok2
+            q.empty?.println
+            t.join
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(gc_configuration)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.gc
+
+        func main
+            var gc := new GC
+            gc.expand_heap(1024u * 1024u).println
+            gc.set_free_space_divisor(4u)
+            gc.enable_incremental
+            gc.collect
+            __builtin_gc_collect()
+
+            s := gc.stats
+            s.heap_size.println
+            s.bytes_since_gc.println
+            s.collections.println
+            s.pause_time_ns.println
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(bench_builtins)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.bench
+
+        class foo
+            a
+        end
+
+        func main
+            start := __builtin_monotonic_ns()
+            __builtin_black_box(42).println
+            __builtin_black_box(3.14).println
+            __builtin_black_box("aaa").println
+            __builtin_black_box(new foo{1}).a.println
+            (__builtin_monotonic_ns() - start).println
+
+            var b := new bench{"test"}
+            b.set_num_samples(3u)
+            b.set_min_sample_ns(1000u)
+            b.of("sort") do
+                black_box([3, 1, 2]).sort
+            end
+            b.of("sum") do
+                var i := 0
+                for i < 100
+                    i += black_box(1)
+                end
+            end
+            b.run
+        end
+    )");
+}
+
+BOOST_AUTO_TEST_CASE(heap_profile)
+{
+    auto t = p.parse(R"(
+        class foo
+            a
+        end
+
+        func main
+            var f := new foo{42}
+            var arr := [1, 2, 3]
+            var ptr := new pointer(int){arr.size}
+            var l := -> f.a + ptr[0]
+            l().println
+        end
+    )", "test_file");
+    dachs::syntax::importer i{{}, "test_file"};
+    auto s = dachs::semantics::analyze_semantics(t, i);
+    dachs::codegen::llvmir::context c;
+    dachs::codegen::gc_options opts;
+    opts.heap_profile = true;
+    auto &m = dachs::codegen::llvmir::emit_llvm_ir(t, s, c, opts);
+    BOOST_CHECK(is_valid_module(m));
+
+    auto const* const malloc_func = m.getFunction("__dachs_profiled_malloc__");
+    BOOST_REQUIRE(malloc_func);
+    BOOST_CHECK(malloc_func->isDeclaration());
+
+    // Note:
+    // Each allocation passes its site "{file}:{line}:{col}" as a constant string.
+    std::size_t num_calls = 0u;
+    for (auto &f : m) {
+        for (auto &block : f) {
+            for (auto &inst : block) {
+                auto const* const call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                if (!call || call->getCalledFunction() != malloc_func) {
+                    continue;
+                }
+                BOOST_REQUIRE(call->getNumArgOperands() == 2u);
+
+                auto const* const site_var = llvm::dyn_cast<llvm::GlobalVariable>(call->getArgOperand(1)->stripPointerCasts());
+                BOOST_REQUIRE(site_var);
+                BOOST_REQUIRE(site_var->hasInitializer());
+                auto const* const site_init = llvm::dyn_cast<llvm::ConstantDataArray>(site_var->getInitializer());
+                BOOST_REQUIRE(site_init);
+
+                auto const site = site_init->getAsCString();
+                BOOST_CHECK(site.startswith("test_file:"));
+                auto const line_col = site.substr(std::strlen("test_file:")).split(':');
+                unsigned line, col;
+                BOOST_CHECK(!line_col.first.getAsInteger(10, line) && line > 0u);
+                BOOST_CHECK(!line_col.second.getAsInteger(10, col));
+
+                ++num_calls;
+            }
+        }
+    }
+    BOOST_CHECK(num_calls > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(profile_functions)
+{
+    auto t = p.parse(R"(
+        func fib(n)
+            ret if n <= 1 then n else fib(n - 1) + fib(n - 2) end
+        end
+
+        func main
+            fib(10).println
+            fib(10u).println
+            [1, 2, 3].each do |i|
+                i.println
+            end
+        end
+    )", "test_file");
+    dachs::syntax::importer i{{}, "test_file"};
+    auto s = dachs::semantics::analyze_semantics(t, i);
+    dachs::codegen::llvmir::context c;
+    dachs::codegen::instrumentation_options opts;
+    opts.profile_functions = true;
+    auto &m = dachs::codegen::llvmir::emit_llvm_ir(t, s, c, {}, {}, opts);
+    BOOST_CHECK(is_valid_module(m));
+    BOOST_CHECK(m.getFunction("dachs.profile.init"));
+
+    auto const* const enter_func = m.getFunction("__dachs_function_enter__");
+    auto const* const exit_func = m.getFunction("__dachs_function_exit__");
+    BOOST_REQUIRE(enter_func);
+    BOOST_REQUIRE(exit_func);
+
+    // Note:
+    // Each instrumented function notifies its entry once and each of its returns.
+    std::size_t num_fibs = 0u, num_lambdas = 0u;
+    for (auto &f : m) {
+        auto const name = f.getName();
+        bool const is_fib = name.find(" fib(") != llvm::StringRef::npos;
+        bool const is_lambda = name.find("lambda.") != llvm::StringRef::npos && !name.endswith(".wrapped");
+        if (f.isDeclaration() || (!is_fib && !is_lambda)) {
+            continue;
+        }
+
+        std::size_t enters = 0u, exits = 0u, rets = 0u;
+        for (auto &block : f) {
+            for (auto &inst : block) {
+                if (auto const* const call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+                    enters += call->getCalledFunction() == enter_func;
+                    exits += call->getCalledFunction() == exit_func;
+                } else if (llvm::isa<llvm::ReturnInst>(inst)) {
+                    ++rets;
+                }
+            }
+        }
+        BOOST_CHECK(enters == 1u);
+        BOOST_CHECK(rets > 0u);
+        BOOST_CHECK(exits == rets);
+
+        num_fibs += is_fib;
+        num_lambdas += is_lambda;
+    }
+    BOOST_CHECK(num_fibs == 2u);
+    BOOST_CHECK(num_lambdas > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(debug_info)
+{
+    auto t = p.parse(R"(
+        class foo
+            a
+
+            func get
+                ret @a
+            end
+        end
+
+        func twice(x)
+            ret x * 2
+        end
+
+        func main
+            twice(21).println
+            twice(1.5).println
+            new foo{42}.get.println
+            [1, 2, 3].each do |i|
+                i.println
+            end
+        end
+    )", "test_file.dcs");
+    dachs::syntax::importer i{{}, "test_file.dcs"};
+    auto s = dachs::semantics::analyze_semantics(t, i);
+    dachs::codegen::llvmir::context c;
+    dachs::codegen::debug_options opts;
+    opts.debug_info = true;
+    opts.frame_pointer = true;
+    auto &m = dachs::codegen::llvmir::emit_llvm_ir(t, s, c, {}, opts);
+    BOOST_CHECK(m.getNamedMetadata("llvm.dbg.cu"));
+    auto const* const main_func = m.getFunction("dachs.main");
+    BOOST_REQUIRE(main_func);
+    BOOST_CHECK(main_func->getAttributes().hasAttribute(llvm::AttributeSet::FunctionIndex, "no-frame-pointer-elim"));
+}
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    CHECK_NO_THROW_CODEGEN_ERROR(R"(
+        import std.arena
+
+        class point
+            x, y
+        end
+
+        func main
+            with_arena do
+                var ps := [] : [point]
+                for i in [1, 2, 3]
+                    ps << new point{i, i * 2}
+                end
+                ps.size.println
+            end
+
+            var a := new arena{4096u}
+            a.use do
+                p := new point{1.0, 2.0}
+                p.x.println
+            end
+            a.allocated_bytes.println
+            a.release
+        end
+    )");
+}
+
 BOOST_AUTO_TEST_CASE(getchar_builtin_function)
 {
     CHECK_NO_THROW_CODEGEN_ERROR(R"(
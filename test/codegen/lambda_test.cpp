@@ -572,4 +572,61 @@ BOOST_AUTO_TEST_CASE(lambda_expression)
     )");
 }
 
+BOOST_AUTO_TEST_CASE(non_escaping_lambda)
+{
+    auto t = p.parse(R"(
+        func each_twice(x, f)
+            f(x)
+            f(x)
+        end
+
+        func forward(x, f)
+            each_twice(x, f)
+        end
+
+        func count_down(n, f)
+            if n > 0
+                f(n)
+                count_down(n - 1, f)
+            end
+        end
+
+        func keep(f)
+            ret f
+        end
+
+        func wrap(f)
+            ret -> x in f(x)
+        end
+
+        func main
+            a := 42
+            each_twice(1) do |i|
+                println(i + a)
+            end
+
+            var i := 0
+            for i < 3
+                forward(i) do |j|
+                    println(j + a)
+                end
+                i += 1
+            end
+
+            count_down(3) do |n|
+                println(n * a)
+            end
+
+            # Escaping lambdas
+            keep(-> a)().println
+            wrap(-> x in println(x + a))(1)
+        end
+    )", "test_file");
+    dachs::syntax::importer i{{}, "test_file"};
+    auto s = dachs::semantics::analyze_semantics(t, i);
+    BOOST_CHECK_EQUAL(s.stack_lambda_receivers.size(), 3u);
+    dachs::codegen::llvmir::context c;
+    BOOST_CHECK_NO_THROW(dachs::codegen::llvmir::emit_llvm_ir(t, s, c));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
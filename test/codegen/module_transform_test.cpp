@@ -0,0 +1,340 @@
+#define BOOST_TEST_MODULE LLVMCodegenModuleTransformTest
+#define BOOST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include "../test_helper.hpp"
+#include "./codegen_test_helper.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dachs/codegen/llvmir/pgo.hpp"
+#include "dachs/codegen/llvmir/module_splitter.hpp"
+#include "dachs/codegen/llvmir/executable_generator.hpp"
+
+using namespace dachs::test;
+
+BOOST_AUTO_TEST_SUITE(codegen_llvm)
+
+BOOST_AUTO_TEST_CASE(pgo)
+{
+    using dachs::codegen::llvmir::detail::walk_pgo_counters;
+    using dachs::codegen::llvmir::detail::is_pgo_target;
+    using dachs::codegen::llvmir::detail::pgo_checksum;
+
+    auto const emit = [](dachs::codegen::llvmir::context &c) -> llvm::Module &
+        {
+            auto t = p.parse(R"(
+                func abs(x)
+                    ret if x < 0 then -x else x end
+                end
+
+                func main
+                    var i := -3
+                    for i < 3
+                        abs(i).println
+                        i += 1
+                    end
+                end
+            )", "test_file");
+            dachs::syntax::importer i{{}, "test_file"};
+            auto s = dachs::semantics::analyze_semantics(t, i);
+            return dachs::codegen::llvmir::emit_llvm_ir(t, s, c);
+        };
+
+    // Note:
+    // Layout of counters and checksums must not be changed by instrumentation
+    // because the profile is applied to the IR before instrumentation.
+    {
+        dachs::codegen::llvmir::context c;
+        auto &m = emit(c);
+
+        std::map<std::string, std::vector<std::size_t>> layouts;
+        std::map<std::string, std::uint64_t> checksums;
+        for (auto &f : m) {
+            if (is_pgo_target(f)) {
+                auto &l = layouts[f.getName().str()];
+                l.push_back(walk_pgo_counters(f, [&l](auto const, auto const idx){ l.push_back(idx); }));
+                checksums[f.getName().str()] = pgo_checksum(f);
+            }
+        }
+        BOOST_REQUIRE(!layouts.empty());
+
+        std::string const file = "test.profdata";
+        dachs::codegen::llvmir::detail::pgo_instrumenter{c, m, file}.instrument();
+        BOOST_CHECK(is_valid_module(m));
+        BOOST_CHECK(m.getFunction("dachs.pgo.init"));
+
+        for (auto &f : m) {
+            if (!is_pgo_target(f)) {
+                continue;
+            }
+
+            std::vector<std::size_t> l;
+            l.push_back(walk_pgo_counters(f, [&l](auto const, auto const idx){ l.push_back(idx); }));
+            BOOST_CHECK(layouts[f.getName().str()] == l);
+            BOOST_CHECK(checksums[f.getName().str()] == pgo_checksum(f));
+        }
+    }
+
+    // Note:
+    // Functions in the profile get branch weights and functions never called
+    // are cold.  'dachs.main' has the same number of counters as in the profile
+    // but its checksum doesn't match, so it is not annotated.
+    {
+        dachs::codegen::llvmir::context c;
+        auto &m = emit(c);
+
+        auto &llvm_ctx = c.llvm_context;
+        std::vector<llvm::Type *> const params = {llvm::Type::getInt32Ty(llvm_ctx)};
+        auto *const sw_func = llvm::Function::Create(
+                llvm::FunctionType::get(llvm::Type::getVoidTy(llvm_ctx), params, false),
+                llvm::Function::ExternalLinkage,
+                "dachs.test.switch",
+                &m
+            );
+        auto *const entry = llvm::BasicBlock::Create(llvm_ctx, "entry", sw_func);
+        auto *const one = llvm::BasicBlock::Create(llvm_ctx, "one", sw_func);
+        auto *const exit = llvm::BasicBlock::Create(llvm_ctx, "exit", sw_func);
+        llvm::IRBuilder<> builder{entry};
+        auto *const sw = builder.CreateSwitch(&*sw_func->arg_begin(), exit, 1u);
+        sw->addCase(builder.getInt32(1), one);
+        builder.SetInsertPoint(one);
+        builder.CreateBr(exit);
+        builder.SetInsertPoint(exit);
+        builder.CreateRetVoid();
+
+        dachs::runtime::pgo_profile profile;
+        for (auto &f : m) {
+            if (!is_pgo_target(f)) {
+                continue;
+            }
+
+            auto &func = profile.functions[f.getName().str()];
+            func.checksum = pgo_checksum(f);
+            auto &counts = func.counts;
+            counts.resize(walk_pgo_counters(f, [](auto const, auto const){}), 0u);
+            walk_pgo_counters(
+                    f,
+                    [&counts](auto const* const inst, auto const idx)
+                    {
+                        if (llvm::isa<llvm::BranchInst>(inst)) {
+                            counts[idx] = 7u;
+                            counts[idx + 1u] = 3u;
+                        } else {
+                            counts[idx] = 10u;
+                            counts[idx + 1u] = 4u;
+                        }
+                    }
+                );
+        }
+        profile.functions["dachs.main"].checksum ^= 1u;
+        profile.functions["dachs.test.switch"].counts[0] = 10u;
+
+        dachs::codegen::llvmir::detail::pgo_annotator{profile}.annotate(m);
+        BOOST_CHECK(is_valid_module(m));
+
+        auto const weight_of = [](llvm::Instruction const* const inst, unsigned const i)
+            {
+                auto const* const md = inst->getMetadata(llvm::LLVMContext::MD_prof);
+                return llvm::cast<llvm::ConstantInt>(md->getOperand(i + 1u))->getZExtValue();
+            };
+
+        std::size_t num_annotated = 0u;
+        for (auto &f : m) {
+            if (!is_pgo_target(f)) {
+                continue;
+            }
+
+            bool const is_main = f.getName() == "dachs.main";
+            bool const is_switch = f.getName() == "dachs.test.switch";
+            BOOST_CHECK(f.hasFnAttribute(llvm::Attribute::Cold) == (!is_main && !is_switch));
+
+            walk_pgo_counters(
+                    f,
+                    [&](auto const* const inst, auto const)
+                    {
+                        if (is_main) {
+                            BOOST_CHECK(!inst->getMetadata(llvm::LLVMContext::MD_prof));
+                            return;
+                        }
+
+                        BOOST_REQUIRE(inst->getMetadata(llvm::LLVMContext::MD_prof));
+                        if (llvm::isa<llvm::BranchInst>(inst)) {
+                            BOOST_CHECK(weight_of(inst, 0u) == 7u);
+                            BOOST_CHECK(weight_of(inst, 1u) == 3u);
+                        } else {
+                            // Note: The default case is executed in the rest of executions.
+                            BOOST_CHECK(weight_of(inst, 0u) == 6u);
+                            BOOST_CHECK(weight_of(inst, 1u) == 4u);
+                        }
+                        ++num_annotated;
+                    }
+                );
+        }
+        BOOST_CHECK(num_annotated >= 2u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(module_splitter)
+{
+    dachs::codegen::llvmir::context c;
+    auto &llvm_ctx = c.llvm_context;
+    llvm::Module m{"test_module", llvm_ctx};
+    llvm::IRBuilder<> builder{llvm_ctx};
+    auto *const i64_ty = builder.getInt64Ty();
+
+    // Note:
+    // A private global, an internal function referred from other functions,
+    // external and linkonce functions and a global constructor.
+    auto *const counter = new llvm::GlobalVariable(m, i64_ty, false, llvm::GlobalValue::PrivateLinkage, builder.getInt64(0u), "counter");
+
+    auto const create_func
+        = [&](char const* const name, llvm::GlobalValue::LinkageTypes const linkage)
+        {
+            auto *const f = llvm::Function::Create(llvm::FunctionType::get(i64_ty, false), linkage, name, &m);
+            builder.SetInsertPoint(llvm::BasicBlock::Create(llvm_ctx, "entry", f));
+            return f;
+        };
+
+    auto *const helper = create_func("helper", llvm::GlobalValue::InternalLinkage);
+    auto *const next = builder.CreateAdd(builder.CreateLoad(counter), builder.getInt64(1u));
+    builder.CreateStore(next, counter);
+    builder.CreateRet(next);
+
+    create_func("foo", llvm::GlobalValue::ExternalLinkage);
+    builder.CreateRet(builder.CreateCall(helper));
+
+    create_func("bar", llvm::GlobalValue::ExternalLinkage);
+    builder.CreateRet(builder.CreateMul(builder.CreateCall(helper), builder.CreateCall(helper)));
+
+    create_func("baz", llvm::GlobalValue::LinkOnceODRLinkage);
+    builder.CreateRet(builder.CreateLoad(counter));
+
+    auto *const init = llvm::Function::Create(llvm::FunctionType::get(builder.getVoidTy(), false), llvm::GlobalValue::InternalLinkage, "init", &m);
+    builder.SetInsertPoint(llvm::BasicBlock::Create(llvm_ctx, "entry", init));
+    builder.CreateStore(builder.getInt64(42u), counter);
+    builder.CreateRetVoid();
+    llvm::appendToGlobalCtors(m, init, 0);
+
+    BOOST_REQUIRE(is_valid_module(m));
+
+    dachs::codegen::llvmir::detail::module_splitter const splitter{m, 3u};
+    BOOST_REQUIRE(splitter.size() == 3u);
+    BOOST_CHECK(is_valid_module(m));
+
+    // Note:
+    // Local symbols are renamed in the original module before splitting.
+    std::vector<std::string> defined_funcs, renamed;
+    for (auto const& f : m) {
+        if (!f.isDeclaration()) {
+            defined_funcs.push_back(f.getName().str());
+        }
+    }
+    for (auto const* const g : {static_cast<llvm::GlobalValue const*>(counter), static_cast<llvm::GlobalValue const*>(helper), static_cast<llvm::GlobalValue const*>(init)}) {
+        BOOST_CHECK(g->getName().find(".dachs.") != llvm::StringRef::npos);
+        BOOST_CHECK(!g->hasLocalLinkage());
+        renamed.push_back(g->getName().str());
+    }
+    BOOST_REQUIRE(defined_funcs.size() == 5u);
+
+    // Note:
+    // Contexts must be destroyed after their modules.
+    std::vector<std::unique_ptr<llvm::LLVMContext>> contexts;
+    std::vector<std::unique_ptr<llvm::Module>> partitions;
+    for (auto i = 0u; i < splitter.size(); ++i) {
+        contexts.emplace_back(new llvm::LLVMContext);
+        partitions.push_back(splitter.extract(i, *contexts.back()));
+        BOOST_CHECK(is_valid_module(*partitions.back()));
+    }
+
+    // Note:
+    // Each function body is in exactly one partition.
+    for (auto const& name : defined_funcs) {
+        auto num_defined = 0u;
+        for (auto const& part : partitions) {
+            auto const* const f = part->getFunction(name);
+            BOOST_REQUIRE(f);
+            if (!f->isDeclaration()) {
+                ++num_defined;
+            }
+        }
+        BOOST_CHECK(num_defined == 1u);
+    }
+
+    // Note:
+    // Globals and constructors are defined only in the first partition.
+    for (auto i = 0u; i < partitions.size(); ++i) {
+        auto const& part = *partitions[i];
+        auto const* const g = part.getNamedGlobal(renamed[0]);
+        BOOST_REQUIRE(g);
+        BOOST_CHECK(g->isDeclaration() == (i != 0u));
+        BOOST_CHECK((part.getNamedGlobal("llvm.global_ctors") != nullptr) == (i == 0u));
+    }
+
+    // Note:
+    // Renamed symbols refer to the same names in all partitions.
+    for (auto const& part : partitions) {
+        for (auto const& name : renamed) {
+            auto const* const v = part->getNamedValue(name);
+            BOOST_REQUIRE(v);
+            BOOST_CHECK(!v->hasLocalLinkage());
+        }
+        BOOST_CHECK(!part->getNamedValue("helper"));
+        BOOST_CHECK(!part->getNamedValue("counter"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merge_functions)
+{
+    auto t = p.parse(R"(
+        func main
+            [1, 2, 3].include?(2).println
+            [1u, 2u, 3u].include?(2u).println
+        end
+    )", "test_file");
+    dachs::syntax::importer i{{}, "test_file"};
+    auto s = dachs::semantics::analyze_semantics(t, i);
+    dachs::codegen::llvmir::context c;
+    auto &m = dachs::codegen::llvmir::emit_llvm_ir(t, s, c);
+    dachs::codegen::llvmir::optimize_modules({&m}, c);
+    BOOST_CHECK(is_valid_module(m));
+
+    std::vector<llvm::Function *> include_funcs;
+    for (auto &f : m) {
+        if (!f.isDeclaration() && f.getName().find("include?") != llvm::StringRef::npos) {
+            include_funcs.push_back(&f);
+        }
+    }
+    BOOST_REQUIRE(include_funcs.size() == 2u);
+
+    // Note:
+    // array(int)#include? and array(uint)#include? are identical.  One of them
+    // must remain as a thunk which only calls the other.
+    auto const is_thunk_of
+        = [](llvm::Function const& thunk, llvm::Function const& target)
+        {
+            if (thunk.size() != 1u) {
+                return false;
+            }
+
+            std::size_t num_calls = 0u;
+            bool calls_target = false;
+            for (auto const& inst : thunk.front()) {
+                if (auto const* const call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+                    ++num_calls;
+                    calls_target = call->getCalledFunction() == &target;
+                }
+            }
+            return num_calls == 1u && calls_target;
+        };
+
+    BOOST_CHECK(
+        is_thunk_of(*include_funcs[0], *include_funcs[1])
+        || is_thunk_of(*include_funcs[1], *include_funcs[0])
+    );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
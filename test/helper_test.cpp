@@ -4,10 +4,13 @@
 
 #include <type_traits>
 #include <string>
+#include <sstream>
 
 #include <boost/test/included/unit_test.hpp>
 
 #include "dachs/helper/probable.hpp"
+#include "dachs/helper/time_report.hpp"
+#include "dachs/helper/compile_stats.hpp"
 
 using namespace dachs::helper;
 
@@ -136,4 +139,93 @@ BOOST_AUTO_TEST_CASE(edge_case_string)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(time_report_test)
+
+BOOST_AUTO_TEST_CASE(nested_phases)
+{
+    time_report report{time_report::format::json};
+    report.set_file("foo.dcs");
+    auto const parsed = report.measure("parse", []{ return 42; });
+    BOOST_CHECK_EQUAL(parsed, 42);
+    report.measure("forward analysis", [&]{ report.measure("import", []{}); });
+    report.set_file("");
+    report.measure("link", []{});
+
+    auto const& entries = report.get_entries();
+    BOOST_CHECK_EQUAL(entries.size(), 4u);
+    BOOST_CHECK_EQUAL(entries[1].phase, "forward analysis");
+    BOOST_CHECK_EQUAL(entries[1].depth, 0u);
+    BOOST_CHECK_EQUAL(entries[2].phase, "import");
+    BOOST_CHECK_EQUAL(entries[2].depth, 1u);
+    BOOST_CHECK_EQUAL(entries[2].file, "foo.dcs");
+    BOOST_CHECK(entries[3].file.empty());
+    BOOST_CHECK(entries[1].wall_sec >= entries[2].wall_sec);
+    BOOST_CHECK(entries[3].peak_rss_kb > 0);
+
+    std::ostringstream out;
+    report.print(out);
+    BOOST_CHECK(out.str().find("\"phase\":\"import\",\"depth\":1") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+    time_report report;
+    BOOST_CHECK(!report.enabled());
+    BOOST_CHECK_EQUAL(report.measure("parse", []{ return 1; }), 1);
+    BOOST_CHECK(report.get_entries().empty());
+
+    std::ostringstream out;
+    report.print(out);
+    BOOST_CHECK(out.str().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(compile_stats_test)
+
+BOOST_AUTO_TEST_CASE(instantiations_and_sizes)
+{
+    compile_stats stats{true};
+    stats.add_instantiations({{"func id(T)", {"int"}}, {"class array", {"elem: int"}}});
+    stats.add_instantiations({{"func id(T)", {"float", "int"}}});
+    BOOST_CHECK_EQUAL(stats.get_instantiations().at("func id(T)").size(), 3u);
+
+    stats.record_size_before_opt("a.dcs", "main", 10u);
+    stats.record_size_after_opt("a.dcs", "main", 30u);
+    stats.record_size_before_opt("a.dcs", "id(int)", 5u);
+    stats.record_size_before_opt("b.dcs", "main", 20u);
+    stats.record_size_after_opt("b.dcs", "main", 12u);
+
+    auto const sizes = stats.get_func_sizes();
+    BOOST_REQUIRE_EQUAL(sizes.size(), 3u);
+    BOOST_CHECK_EQUAL(sizes[0].file, "a.dcs");
+    BOOST_CHECK_EQUAL(sizes[0].after_opt, 30u);
+    BOOST_CHECK_EQUAL(sizes[1].file, "b.dcs");
+    BOOST_CHECK_EQUAL(sizes[2].name, "id(int)");
+    BOOST_CHECK_EQUAL(sizes[2].after_opt, 0u);
+
+    std::ostringstream out;
+    stats.print(out, 2u);
+    BOOST_CHECK(out.str().find("Template instantiations: 4 of 2 templates") != std::string::npos);
+    BOOST_CHECK(out.str().find("(float)") != std::string::npos);
+    BOOST_CHECK(out.str().find("35 before optimization, 42 after optimization in 3 functions") != std::string::npos);
+    BOOST_CHECK(out.str().find("... and 1 more functions") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+    compile_stats stats;
+    BOOST_CHECK(!stats.enabled());
+    stats.add_instantiations({{"func id(T)", {"int"}}});
+    stats.record_size_before_opt("a.dcs", "main", 10u);
+    BOOST_CHECK(stats.get_instantiations().empty());
+    BOOST_CHECK(stats.get_func_sizes().empty());
+
+    std::ostringstream out;
+    stats.print(out);
+    BOOST_CHECK(out.str().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -482,6 +482,17 @@ BOOST_AUTO_TEST_CASE(literals)
             0o01234567
             0o01234567u
 
+            # fixed-width
+            42i8
+            42i16
+            42i32
+            255u8
+            42u32
+            0xffu8
+            0b0101i16
+            3.14f32
+            -1.5f32
+
             # array
             [1, 10, 100, 1000, 10000]
             [
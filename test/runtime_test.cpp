@@ -4,10 +4,36 @@
 
 #include <random>
 #include <string>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include <unistd.h>
+#include <pthread.h>
 
 #include <boost/test/included/unit_test.hpp>
 
+#define GC_THREADS
+#include <gc.h>
+
 #include "dachs/runtime.hpp"
+#include "dachs/number.hpp"
+#include "dachs/io.hpp"
+#include "dachs/file.hpp"
+#include "dachs/task.hpp"
+#include "dachs/channel.hpp"
+#include "dachs/gc.hpp"
+#include "dachs/heap_profile.hpp"
+#include "dachs/function_profile.hpp"
+#include "dachs/pgo_profile.hpp"
+#include "dachs/arena.hpp"
+#include "dachs/alloc_cache.hpp"
 
 std::mt19937 random_engine{std::random_device{}()};
 
@@ -52,5 +78,772 @@ BOOST_AUTO_TEST_CASE(cityhash64)
     }
 }
 
+inline std::string int_to_string(std::int64_t const i, std::uint64_t const base)
+{
+    char buf[70];
+    auto const size = dachs::runtime::format_int(buf, i, base);
+    BOOST_CHECK(size == dachs::runtime::int_length(i, base));
+    return {buf, size};
+}
+
+inline std::string float_to_string(double const d)
+{
+    char buf[dachs::runtime::max_float_length];
+    return {buf, dachs::runtime::format_float(buf, d)};
+}
+
+BOOST_AUTO_TEST_CASE(format_integer)
+{
+    BOOST_CHECK(int_to_string(0, 10u) == "0");
+    BOOST_CHECK(int_to_string(-42, 10u) == "-42");
+    BOOST_CHECK(int_to_string(100, 10u) == "100");
+    BOOST_CHECK(int_to_string(255, 16u) == "ff");
+    BOOST_CHECK(int_to_string(-5, 2u) == "-101");
+    BOOST_CHECK(int_to_string(std::numeric_limits<std::int64_t>::min(), 10u) == "-9223372036854775808");
+    BOOST_CHECK(int_to_string(std::numeric_limits<std::int64_t>::max(), 10u) == "9223372036854775807");
+
+    char buf[32];
+    auto const size = dachs::runtime::format_uint(buf, std::numeric_limits<std::uint64_t>::max(), 10u);
+    BOOST_CHECK(std::string(buf, size) == "18446744073709551615");
+
+    std::uniform_int_distribution<std::int64_t> d;
+    for (auto i = 0u; i < 10000u; ++i) {
+        auto const v = d(random_engine);
+        BOOST_CHECK(int_to_string(v, 10u) == std::to_string(v));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(format_float)
+{
+    BOOST_CHECK(float_to_string(0.0) == "0.0");
+    BOOST_CHECK(float_to_string(-0.0) == "-0.0");
+    BOOST_CHECK(float_to_string(1.0) == "1.0");
+    BOOST_CHECK(float_to_string(0.1) == "0.1");
+    BOOST_CHECK(float_to_string(-2.5) == "-2.5");
+    BOOST_CHECK(float_to_string(1e16) == "1e+16");
+    BOOST_CHECK(float_to_string(1.5e-5) == "1.5e-05");
+    BOOST_CHECK(float_to_string(5e-324) == "5e-324");
+    BOOST_CHECK(float_to_string(1.7976931348623157e308) == "1.7976931348623157e+308");
+    BOOST_CHECK(float_to_string(std::numeric_limits<double>::infinity()) == "inf");
+
+    // Note:
+    // Round trip of random bit patterns
+    std::uniform_int_distribution<std::uint64_t> d;
+    for (auto i = 0u; i < 10000u; ++i) {
+        auto const bits = d(random_engine);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        if (v != v) {
+            continue;
+        }
+        BOOST_CHECK(std::strtod(float_to_string(v).c_str(), nullptr) == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parse_number)
+{
+    std::int64_t i = 0;
+    BOOST_CHECK(dachs::runtime::parse_int("-1234", 5u, 10u, i) && i == -1234);
+    BOOST_CHECK(dachs::runtime::parse_int("ff", 2u, 16u, i) && i == 255);
+    BOOST_CHECK(dachs::runtime::parse_int("-9223372036854775808", 20u, 10u, i) && i == std::numeric_limits<std::int64_t>::min());
+    BOOST_CHECK(!dachs::runtime::parse_int("9223372036854775808", 19u, 10u, i));
+    BOOST_CHECK(!dachs::runtime::parse_int("", 0u, 10u, i));
+    BOOST_CHECK(!dachs::runtime::parse_int("12a", 3u, 10u, i));
+
+    double f = 0.0;
+    BOOST_CHECK(dachs::runtime::parse_float("3.14", 4u, f) && f == 3.14);
+    BOOST_CHECK(dachs::runtime::parse_float("-1e-300", 7u, f) && f == -1e-300);
+    BOOST_CHECK(dachs::runtime::parse_float("0.30000000000000004441", 22u, f) && f == 0.30000000000000004441);
+    BOOST_CHECK(!dachs::runtime::parse_float("1.", 2u, f));
+    BOOST_CHECK(!dachs::runtime::parse_float("e5", 2u, f));
+    BOOST_CHECK(!dachs::runtime::parse_float("", 0u, f));
+    BOOST_CHECK(!dachs::runtime::parse_float("1e400", 5u, f));
+    BOOST_CHECK(!dachs::runtime::parse_float("-1e400", 6u, f));
+    BOOST_CHECK(dachs::runtime::parse_float("-inf", 4u, f) && f == -__builtin_huge_val());
+    BOOST_CHECK(dachs::runtime::parse_float("1e-400", 6u, f) && f == 0.0);
+
+    std::uniform_int_distribution<std::uint64_t> d;
+    for (auto n = 0u; n < 10000u; ++n) {
+        auto const bits = d(random_engine);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        if (v != v) {
+            continue;
+        }
+        auto const s = float_to_string(v);
+        BOOST_CHECK(dachs::runtime::parse_float(s.data(), s.size(), f) && f == v);
+    }
+}
+
+// Note:
+// Return the read end of a pipe which has 'content'
+inline int pipe_of(std::string const& content)
+{
+    int fds[2];
+    BOOST_REQUIRE(::pipe(fds) == 0);
+    BOOST_REQUIRE(::write(fds[1], content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+    ::close(fds[1]);
+    return fds[0];
+}
+
+BOOST_AUTO_TEST_CASE(input_buffer)
+{
+    char const* data;
+    std::size_t size;
+
+    {
+        // Note:
+        // Small capacity to check that the buffer grows for long lines
+        dachs::runtime::input_buffer in{pipe_of("foo\n\nlong line over the buffer\nlast"), 4u};
+        BOOST_CHECK(in.read_line(data, size) && std::string(data, size) == "foo");
+        BOOST_CHECK(in.read_line(data, size) && size == 0u);
+        BOOST_CHECK(in.read_line(data, size) && std::string(data, size) == "long line over the buffer");
+        BOOST_CHECK(in.read_line(data, size) && std::string(data, size) == "last");
+        BOOST_CHECK(!in.read_line(data, size));
+        BOOST_CHECK(in.eof());
+    }
+
+    {
+        dachs::runtime::input_buffer in{pipe_of("  12 -3\n\tabcdefgh  \n"), 4u};
+        BOOST_CHECK(in.read_token(data, size) && std::string(data, size) == "12");
+        BOOST_CHECK(in.read_token(data, size) && std::string(data, size) == "-3");
+        BOOST_CHECK(in.read_token(data, size) && std::string(data, size) == "abcdefgh");
+        BOOST_CHECK(!in.read_token(data, size));
+    }
+
+    {
+        dachs::runtime::input_buffer in{pipe_of("ab\ncd\n"), 4u};
+        BOOST_CHECK(in.read_char() == 'a');
+        in.read_all(data, size);
+        BOOST_CHECK(std::string(data, size) == "b\ncd\n");
+        BOOST_CHECK(in.read_char() == -1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(file)
+{
+    char tmpl[] = "/tmp/dachs-runtime-test-XXXXXX";
+    auto const fd = ::mkstemp(tmpl);
+    BOOST_REQUIRE(fd != -1);
+    ::close(fd);
+
+    std::string expected;
+    {
+        auto *const f = dachs::runtime::file::open(tmpl, "w");
+        BOOST_REQUIRE(f);
+        for (auto i = 0u; i < 100000u; ++i) {
+            auto const line = std::to_string(i) + '\n';
+            BOOST_CHECK(f->write(line.data(), line.size()));
+            expected += line;
+        }
+        BOOST_CHECK(f->close());
+        delete f;
+    }
+
+    {
+        auto *const f = dachs::runtime::file::open(tmpl, "r");
+        BOOST_REQUIRE(f);
+        BOOST_CHECK(f->size() == static_cast<std::int64_t>(expected.size()));
+        std::string content(expected.size(), '\0');
+        BOOST_CHECK(f->read(&content[0], content.size()) == expected.size());
+        BOOST_CHECK(content == expected);
+        delete f;
+    }
+
+    {
+        auto *const f = dachs::runtime::file::open(tmpl, "r");
+        BOOST_REQUIRE(f);
+        std::size_t size;
+        auto *const data = f->read_all(size, std::realloc);
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(size == expected.size());
+        BOOST_CHECK(std::string(data, size) == expected);
+        BOOST_CHECK(data[size] == '\0');
+        std::free(data);
+        delete f;
+    }
+
+    {
+        // Note: The size of a pipe is unknown.  It is read until EOF.
+        int fds[2];
+        BOOST_REQUIRE(::pipe(fds) == 0);
+        std::thread writer{
+            [&fds, &expected]
+            {
+                auto const* data = expected.data();
+                auto rest = expected.size();
+                while (rest > 0u) {
+                    auto const written = ::write(fds[1], data, rest < 1000u ? rest : 1000u);
+                    if (written <= 0) {
+                        break;
+                    }
+                    data += written;
+                    rest -= static_cast<std::size_t>(written);
+                }
+                ::close(fds[1]);
+            }
+        };
+
+        dachs::runtime::file f{fds[0], 0u};
+        std::size_t size;
+        auto *const data = f.read_all(size, std::realloc);
+        writer.join();
+        BOOST_REQUIRE(data);
+        BOOST_CHECK(size == expected.size());
+        BOOST_CHECK(std::string(data, size) == expected);
+        std::free(data);
+        BOOST_CHECK(f.close());
+    }
+
+    {
+        dachs::runtime::mapped_region region;
+        BOOST_REQUIRE(dachs::runtime::map_file(tmpl, region));
+        BOOST_CHECK(region.size == expected.size());
+        BOOST_CHECK(std::string(region.data, region.size) == expected);
+        BOOST_CHECK(region.data[region.size] == '\0');
+        BOOST_CHECK(dachs::runtime::unmap_file(region));
+    }
+
+    {
+        // Note: Files not closed are flushed by flush_open_files()
+        auto *const f = dachs::runtime::file::open(tmpl, "w");
+        BOOST_REQUIRE(f);
+        BOOST_CHECK(f->write("unclosed", 8u));
+        BOOST_CHECK(f->size() == 0);
+        BOOST_CHECK(dachs::runtime::flush_open_files());
+        BOOST_CHECK(f->size() == 8);
+        delete f;
+        BOOST_CHECK(dachs::runtime::flush_open_files());
+    }
+
+    {
+        auto *const f = dachs::runtime::file::open(tmpl, "r");
+        BOOST_REQUIRE(f);
+        BOOST_CHECK(!f->write("x", 1u));
+        delete f;
+    }
+
+    BOOST_CHECK(!dachs::runtime::file::open("/dachs/does/not/exist", "r"));
+    BOOST_CHECK(!dachs::runtime::file::open(tmpl, "x"));
+    ::unlink(tmpl);
+}
+
+BOOST_AUTO_TEST_CASE(task_scheduler)
+{
+    GC_INIT();
+
+    struct counter_env {
+        std::atomic<std::uint64_t> *counter;
+        std::uint64_t value;
+    };
+
+    auto const add
+        = [](void *const env)
+        {
+            auto *const e = static_cast<counter_env *>(env);
+            e->counter->fetch_add(e->value);
+        };
+
+    dachs::runtime::scheduler sched{4u};
+    BOOST_CHECK(sched.num_workers() == 4u);
+
+    {
+        std::atomic<std::uint64_t> counter{0u};
+        std::vector<counter_env> envs;
+        envs.reserve(10000u);
+        std::vector<dachs::runtime::task *> tasks;
+        for (auto i = 0u; i < 10000u; ++i) {
+            envs.push_back({&counter, i});
+            tasks.push_back(sched.spawn(add, &envs.back()));
+        }
+        for (auto *const t : tasks) {
+            sched.join(t);
+        }
+        BOOST_CHECK(counter.load() == 10000u * 9999u / 2u);
+    }
+
+    // Note:
+    // Tasks spawning and joining child tasks must not deadlock
+    {
+        struct parent_env {
+            dachs::runtime::scheduler *sched;
+            std::atomic<std::uint64_t> *counter;
+        };
+
+        std::atomic<std::uint64_t> counter{0u};
+        std::vector<parent_env> envs(64u, parent_env{&sched, &counter});
+        std::vector<dachs::runtime::task *> tasks;
+        for (auto &e : envs) {
+            tasks.push_back(sched.spawn(
+                [](void *const env)
+                {
+                    auto *const p = static_cast<parent_env *>(env);
+                    counter_env child_env{p->counter, 1u};
+                    std::vector<dachs::runtime::task *> children;
+                    for (auto i = 0u; i < 16u; ++i) {
+                        children.push_back(p->sched->spawn(
+                            [](void *const e)
+                            {
+                                static_cast<counter_env *>(e)->counter->fetch_add(1u);
+                            }, &child_env));
+                    }
+                    for (auto *const c : children) {
+                        p->sched->join(c);
+                    }
+                }, &e));
+        }
+        for (auto *const t : tasks) {
+            sched.join(t);
+        }
+        BOOST_CHECK(counter.load() == 64u * 16u);
+    }
+
+    BOOST_CHECK(dachs::runtime::default_num_workers() > 0u);
+}
+
+BOOST_AUTO_TEST_CASE(channel)
+{
+    using dachs::runtime::bounded_ring;
+    using dachs::runtime::spsc_queue;
+
+    BOOST_CHECK(bounded_ring::round_capacity(0u) == 2u);
+    BOOST_CHECK(bounded_ring::round_capacity(5u) == 8u);
+    BOOST_CHECK(bounded_ring::round_capacity(64u) == 64u);
+
+    {
+        std::vector<std::atomic<std::uint64_t>> sequences(4u);
+        bounded_ring ring{sequences.data(), 4u};
+        std::uint64_t slots[4];
+        std::uint64_t pos;
+
+        BOOST_CHECK(!ring.try_claim_pop(pos));
+        for (auto i = 0u; i < 4u; ++i) {
+            BOOST_REQUIRE(ring.try_claim_push(pos));
+            slots[pos % ring.capacity()] = i;
+            ring.publish_push(pos);
+        }
+        BOOST_CHECK(!ring.try_claim_push(pos));
+        BOOST_CHECK(ring.size() == 4u);
+
+        for (auto i = 0u; i < 4u; ++i) {
+            BOOST_REQUIRE(ring.try_claim_pop(pos));
+            BOOST_CHECK(slots[pos % ring.capacity()] == i);
+            ring.release_pop(pos);
+        }
+        BOOST_CHECK(ring.size() == 0u);
+    }
+
+    // Note:
+    // Multiple producers and consumers.  Sum of received values must match.
+    {
+        std::vector<std::atomic<std::uint64_t>> sequences(64u);
+        bounded_ring ring{sequences.data(), 64u};
+        std::vector<std::uint64_t> slots(64u);
+        std::atomic<std::uint64_t> sum{0u};
+        std::uint64_t const n = 100000u;
+
+        std::vector<std::thread> threads;
+        for (auto t = 0u; t < 4u; ++t) {
+            threads.emplace_back([&]
+                {
+                    for (std::uint64_t i = 1u; i <= n; ++i) {
+                        auto const pos = ring.claim_push();
+                        slots[pos % ring.capacity()] = i;
+                        ring.publish_push(pos);
+                    }
+                });
+            threads.emplace_back([&]
+                {
+                    for (std::uint64_t i = 0u; i < n; ++i) {
+                        auto const pos = ring.claim_pop();
+                        sum.fetch_add(slots[pos % ring.capacity()]);
+                        ring.release_pop(pos);
+                    }
+                });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        BOOST_CHECK(sum.load() == 4u * (n * (n + 1u) / 2u));
+    }
+
+    {
+        spsc_queue queue{std::malloc};
+        void *value;
+        BOOST_CHECK(queue.empty());
+        BOOST_CHECK(!queue.try_pop(value));
+
+        std::vector<std::uintptr_t> received;
+        std::thread consumer{[&]
+            {
+                for (auto i = 0u; i < 100000u; ++i) {
+                    received.push_back(reinterpret_cast<std::uintptr_t>(queue.pop()));
+                }
+            }};
+        for (std::uintptr_t i = 1u; i <= 100000u; ++i) {
+            queue.push(reinterpret_cast<void *>(i));
+        }
+        consumer.join();
+
+        BOOST_CHECK(queue.empty());
+        BOOST_REQUIRE(received.size() == 100000u);
+        for (auto i = 0u; i < received.size(); ++i) {
+            BOOST_CHECK(received[i] == i + 1u);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(gc_config)
+{
+    using dachs::runtime::parse_size;
+
+    std::uint64_t n = 0u;
+    BOOST_CHECK(parse_size("0", n) && n == 0u);
+    BOOST_CHECK(parse_size("42", n) && n == 42u);
+    BOOST_CHECK(parse_size("4k", n) && n == 4096u);
+    BOOST_CHECK(parse_size("64M", n) && n == 64u * 1024u * 1024u);
+    BOOST_CHECK(parse_size("2G", n) && n == 2ull * 1024u * 1024u * 1024u);
+    BOOST_CHECK(!parse_size(nullptr, n));
+    BOOST_CHECK(!parse_size("", n));
+    BOOST_CHECK(!parse_size("-1", n));
+    BOOST_CHECK(!parse_size("12MB", n));
+    BOOST_CHECK(!parse_size("99999999999999999999", n));
+    BOOST_CHECK(!parse_size("17179869184G", n));
+    BOOST_CHECK(!parse_size("99999999999G", n));
+    BOOST_CHECK(parse_size("17179869183G", n) && n == 17179869183ull << 30);
+    BOOST_CHECK(!parse_size("abc", n));
+
+    dachs::runtime::gc_config flags;
+    flags.markers = 2u;
+    flags.initial_heap_size = 1024u;
+
+    ::unsetenv("DACHS_GC_MARKERS");
+    ::unsetenv("DACHS_GC_INCREMENTAL");
+    ::unsetenv("DACHS_GC_INITIAL_HEAP_SIZE");
+    ::unsetenv("DACHS_GC_FREE_SPACE_DIVISOR");
+    {
+        auto const c = dachs::runtime::gc_config_from_env(flags);
+        BOOST_CHECK_EQUAL(c.markers, 2u);
+        BOOST_CHECK(!c.incremental);
+        BOOST_CHECK_EQUAL(c.initial_heap_size, 1024u);
+        BOOST_CHECK_EQUAL(c.free_space_divisor, 0u);
+    }
+
+    ::setenv("DACHS_GC_MARKERS", "4", 1);
+    ::setenv("DACHS_GC_INCREMENTAL", "1", 1);
+    ::setenv("DACHS_GC_INITIAL_HEAP_SIZE", "8M", 1);
+    ::setenv("DACHS_GC_FREE_SPACE_DIVISOR", "invalid", 1);
+    {
+        auto const c = dachs::runtime::gc_config_from_env(flags);
+        BOOST_CHECK_EQUAL(c.markers, 4u);
+        BOOST_CHECK(c.incremental);
+        BOOST_CHECK_EQUAL(c.initial_heap_size, 8u * 1024u * 1024u);
+        BOOST_CHECK_EQUAL(c.free_space_divisor, 0u);
+    }
+
+    ::unsetenv("DACHS_GC_MARKERS");
+    ::unsetenv("DACHS_GC_INCREMENTAL");
+    ::unsetenv("DACHS_GC_INITIAL_HEAP_SIZE");
+    ::unsetenv("DACHS_GC_FREE_SPACE_DIVISOR");
+}
+
+BOOST_AUTO_TEST_CASE(heap_profile)
+{
+    dachs::runtime::heap_profile profile;
+    BOOST_CHECK(profile.entries().empty());
+
+    // Note:
+    // Same site names at different addresses are merged as sites of different modules.
+    char const site_a[] = "a.dcs:1:1";
+    char const site_a2[] = "a.dcs:1:1";
+    char const site_b[] = "b.dcs:2:3";
+
+    profile.record(site_a, 16u);
+    profile.record(site_b, 100u);
+    profile.record(site_a2, 16u);
+    profile.record(nullptr, 8u);
+
+    std::vector<std::thread> threads;
+    for (auto i = 0u; i < 4u; ++i) {
+        threads.emplace_back([&]{
+                for (auto j = 0u; j < 1000u; ++j) {
+                    profile.record(site_a, 1u);
+                }
+            });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    auto const entries = profile.entries();
+    BOOST_REQUIRE(entries.size() == 3u);
+    BOOST_CHECK(entries[0].site == "a.dcs:1:1");
+    BOOST_CHECK(entries[0].bytes == 4032u);
+    BOOST_CHECK(entries[0].objects == 4002u);
+    BOOST_CHECK(entries[1].site == "b.dcs:2:3");
+    BOOST_CHECK(entries[1].bytes == 100u);
+    BOOST_CHECK(entries[1].objects == 1u);
+    BOOST_CHECK(entries[2].site == "<unknown>");
+
+    auto *const out = std::tmpfile();
+    BOOST_REQUIRE(out);
+    profile.report(out);
+    std::rewind(out);
+    char line[256];
+    BOOST_REQUIRE(std::fgets(line, sizeof(line), out));
+    BOOST_CHECK(std::string{line} == "Heap profile: 4140 bytes in 4004 objects at 3 sites\n");
+    std::fclose(out);
+}
+
+BOOST_AUTO_TEST_CASE(function_profile)
+{
+    using dachs::runtime::function_profile;
+
+    // Note:
+    // Slot 2 is the same function as slot 1 in another module.
+    char const main_name[] = "func main()";
+    char const foo_name[] = "func foo(int) : int";
+    char const foo_name2[] = "func foo(int) : int";
+    std::vector<char const*> const names = {main_name, foo_name, foo_name2, "func bar()"};
+
+    // Note:
+    // main (0..100) calls foo (10..30) and foo (40..50) in the first thread.
+    // foo (0..5) is called from the bottom of the stack in the second thread.
+    function_profile p1{names.size()}, p2{names.size()};
+    p1.enter(0u, 0u);
+    p1.enter(1u, 10u);
+    p1.exit(30u);
+    p1.enter(1u, 40u);
+    p1.exit(50u);
+    p1.exit(100u);
+    p1.exit(200u); // Unbalanced exit is ignored
+    p2.enter(2u, 0u);
+    p2.exit(5u);
+    p2.enter(42u, 5u); // Slot out of range is not counted
+    p2.exit(10u);
+
+    std::vector<function_profile const*> const profiles = {&p1, &p2};
+
+    auto const funcs = function_profile::func_entries(profiles, names);
+    BOOST_REQUIRE(funcs.size() == 2u);
+    BOOST_CHECK(funcs[0].name == main_name);
+    BOOST_CHECK(funcs[0].calls == 1u);
+    BOOST_CHECK(funcs[0].inclusive_cycles == 100u);
+    BOOST_CHECK(funcs[0].exclusive_cycles == 70u);
+    BOOST_CHECK(funcs[1].name == foo_name);
+    BOOST_CHECK(funcs[1].calls == 3u);
+    BOOST_CHECK(funcs[1].inclusive_cycles == 35u);
+    BOOST_CHECK(funcs[1].exclusive_cycles == 35u);
+
+    auto const edges = function_profile::edge_entries(profiles, names);
+    BOOST_REQUIRE(edges.size() == 3u);
+    BOOST_CHECK(edges[0].caller == "");
+    BOOST_CHECK(edges[0].callee == main_name);
+    BOOST_CHECK(edges[1].caller == main_name);
+    BOOST_CHECK(edges[1].callee == foo_name);
+    BOOST_CHECK(edges[1].calls == 2u);
+    BOOST_CHECK(edges[1].inclusive_cycles == 30u);
+    BOOST_CHECK(edges[2].caller == "");
+    BOOST_CHECK(edges[2].callee == foo_name);
+
+    auto *const out = std::tmpfile();
+    BOOST_REQUIRE(out);
+    function_profile::report(out, profiles, names);
+    std::rewind(out);
+    char line[256];
+    BOOST_REQUIRE(std::fgets(line, sizeof(line), out));
+    BOOST_CHECK(std::string{line} == "Function profile: 4 calls of 2 functions in 105 cycles\n");
+    std::fclose(out);
+
+    // Note:
+    // Each module gets its own range of slots.
+    char const* const module_names[] = {main_name, foo_name};
+    auto const first = dachs::runtime::register_profiled_functions(module_names, 2u);
+    BOOST_CHECK(dachs::runtime::register_profiled_functions(module_names, 1u) == first + 2u);
+
+    // Note:
+    // Each thread has its own profile.
+    auto *const main_profile = &dachs::runtime::thread_function_profile();
+    BOOST_CHECK(main_profile == &dachs::runtime::thread_function_profile());
+    std::thread{[main_profile]{ BOOST_CHECK(&dachs::runtime::thread_function_profile() != main_profile); }}.join();
+
+    // Note:
+    // A profile can be read while its thread is still running.
+    function_profile live{names.size()};
+    std::atomic<bool> done{false};
+    std::thread worker{
+        [&live, &done]
+        {
+            for (auto i = 0u; i < 10000u; ++i) {
+                live.enter(1u, i);
+                live.exit(i + 1u);
+            }
+            done.store(true);
+        }
+    };
+    while (!done.load()) {
+        auto const fs = function_profile::func_entries({&live}, names);
+        BOOST_CHECK(fs.size() <= 1u);
+        function_profile::edge_entries({&live}, names);
+    }
+    worker.join();
+    auto const fs = function_profile::func_entries({&live}, names);
+    BOOST_REQUIRE(fs.size() == 1u);
+    BOOST_CHECK(fs[0].calls == 10000u);
+}
+
+BOOST_AUTO_TEST_CASE(pgo_profile)
+{
+    using dachs::runtime::pgo_profile;
+
+    pgo_profile p;
+    p.functions["func main()"] = {42u, {1u, 3u, 4u}};
+    p.functions["func foo(int) : int"] = {7u, {7u}};
+
+    std::stringstream ss;
+    p.write(ss);
+    BOOST_CHECK(ss.str() == "dachs-profile 2\n7 1 7 func foo(int) : int\n42 3 1 3 4 func main()\n");
+
+    pgo_profile read;
+    BOOST_REQUIRE(read.read(ss));
+    BOOST_CHECK(read.functions == p.functions);
+
+    // Note:
+    // Counts are summed up when the checksum and the layout match and
+    // replaced otherwise.
+    pgo_profile next;
+    next.functions["func main()"] = {42u, {1u, 1u, 0u}};
+    next.functions["func foo(int) : int"] = {7u, {2u, 1u, 1u}};
+    next.functions["func bar()"] = {1u, {5u}};
+    read.merge(next);
+    BOOST_CHECK((read.functions["func main()"].counts == std::vector<std::uint64_t>{2u, 4u, 4u}));
+    BOOST_CHECK((read.functions["func foo(int) : int"].counts == std::vector<std::uint64_t>{2u, 1u, 1u}));
+    BOOST_CHECK((read.functions["func bar()"].counts == std::vector<std::uint64_t>{5u}));
+
+    pgo_profile changed;
+    changed.functions["func main()"] = {43u, {1u, 1u, 1u}};
+    read.merge(changed);
+    BOOST_CHECK(read.functions["func main()"].checksum == 43u);
+    BOOST_CHECK((read.functions["func main()"].counts == std::vector<std::uint64_t>{1u, 1u, 1u}));
+
+    for (auto const broken : {"", "dachs-profile 1\n1 7 func foo()\n", "dachs-profile 2\n1 3 1 2\n", "dachs-profile 2\n1 1 1\n", "dachs-profile 2\n1\n"}) {
+        std::stringstream in{broken};
+        pgo_profile b;
+        BOOST_CHECK(!b.read(in));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(arena)
+{
+    using dachs::runtime::arena;
+
+    arena a{[](std::size_t const s){ return std::calloc(1u, s); }, 256u};
+    BOOST_CHECK(a.allocated_bytes() == 0u);
+
+    auto *const p = static_cast<char *>(a.allocate(10u));
+    BOOST_REQUIRE(p);
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(p) % arena::alignment == 0u);
+    BOOST_CHECK(arena::size_of(p) == 10u);
+    std::memset(p, 0xff, 10u);
+
+    auto *const q = static_cast<char *>(a.allocate(100u));
+    BOOST_REQUIRE(q);
+    BOOST_CHECK(q >= p + 10u);
+    BOOST_CHECK(arena::size_of(q) == 100u);
+    BOOST_CHECK(a.allocated_bytes() == 110u);
+
+    // Note:
+    // Does not fit in the rest of the first chunk.  A new chunk is allocated.
+    auto *const r = a.allocate(200u);
+    BOOST_REQUIRE(r);
+    BOOST_CHECK(a.allocate(1024u) == nullptr);
+
+    // Note:
+    // Chunks are reused after release and memory is cleared again.
+    a.release();
+    BOOST_CHECK(a.allocated_bytes() == 0u);
+    auto *const p2 = static_cast<char *>(a.allocate(10u));
+    BOOST_CHECK(p2 == p);
+    for (auto i = 0u; i < 10u; ++i) {
+        BOOST_CHECK(p2[i] == 0);
+    }
+    a.allocate(100u);
+    BOOST_CHECK(a.allocate(200u) == r);
+
+    // Note:
+    // The header of an object knows its arena.
+    BOOST_CHECK(arena::owner_of(p2) == &a);
+    BOOST_CHECK(arena::owner_of(r) == &a);
+    {
+        arena b{[](std::size_t const s){ return std::calloc(1u, s); }, 256u};
+        auto *const s = b.allocate(10u);
+        BOOST_CHECK(arena::owner_of(s) == &b);
+        BOOST_CHECK(arena::size_of(s) == 10u);
+    }
+
+    BOOST_CHECK(dachs::runtime::current_arena() == nullptr);
+    BOOST_CHECK(dachs::runtime::switch_arena(&a) == nullptr);
+    BOOST_CHECK(dachs::runtime::current_arena() == &a);
+    std::thread{[]{ BOOST_CHECK(dachs::runtime::current_arena() == nullptr); }}.join();
+    BOOST_CHECK(dachs::runtime::switch_arena(nullptr) == &a);
+}
+
+BOOST_AUTO_TEST_CASE(alloc_cache)
+{
+    using dachs::runtime::cached_alloc;
+
+    auto const check_allocations
+        = []
+        {
+            for (std::size_t size = 1u; size <= dachs::runtime::alloc_cache_max_size; size += 7u) {
+                std::vector<char *> ps;
+                for (auto i = 0u; i < 10u; ++i) {
+                    auto *const p = static_cast<char *>(cached_alloc(size));
+                    BOOST_REQUIRE(p);
+                    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(p) % alignof(void *) == 0u);
+                    BOOST_CHECK(std::all_of(p, p + size, [](char const c){ return c == 0; }));
+                    std::memset(p, 0xff, size);
+                    ps.push_back(p);
+                }
+                std::sort(std::begin(ps), std::end(ps));
+                BOOST_CHECK(std::adjacent_find(std::begin(ps), std::end(ps)) == std::end(ps));
+            }
+        };
+
+    check_allocations();
+
+    // Note:
+    // Each thread has its own free lists.  Free lists are filled by GC, so the
+    // threads are created via GC_pthread_create() as task workers are.
+    std::vector<pthread_t> threads(4u);
+    for (auto &t : threads) {
+        auto const entry
+            = [](void *const f) -> void *
+            {
+                (*static_cast<decltype(check_allocations) const*>(f))();
+                return nullptr;
+            };
+        BOOST_REQUIRE(GC_pthread_create(&t, nullptr, entry, const_cast<void *>(static_cast<void const*>(&check_allocations))) == 0);
+    }
+    for (auto const t : threads) {
+        pthread_join(t, nullptr);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(monotonic_clock)
+{
+    auto const start = __dachs_monotonic_ns__();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto const end = __dachs_monotonic_ns__();
+    BOOST_CHECK(end - start >= 10u * 1000u * 1000u);
+
+    auto prev = __dachs_monotonic_ns__();
+    for (auto i = 0u; i < 1000u; ++i) {
+        auto const now = __dachs_monotonic_ns__();
+        BOOST_CHECK(now >= prev);
+        prev = now;
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 